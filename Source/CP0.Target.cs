@@ -8,6 +8,8 @@ public class CP0Target : TargetRules
 	{
 		Type = TargetType.Game;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
+		BuildEnvironment = TargetBuildEnvironment.Unique;
+		bWithPushModel = true;
 
 		ExtraModuleNames.AddRange(new[] {"CP0"});
 	}
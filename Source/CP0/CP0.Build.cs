@@ -8,7 +8,7 @@ public class CP0 : ModuleRules
 	{
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
-		PublicDependencyModuleNames.AddRange(new[] {"Core", "CoreUObject", "Engine", "InputCore"});
+		PublicDependencyModuleNames.AddRange(new[] {"Core", "CoreUObject", "Engine", "InputCore", "NetCore", "ReplicationGraph"});
 
 		PrivateDependencyModuleNames.AddRange(new string[] { });
 
@@ -0,0 +1,186 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#include "AnimBudget.h"
+#include "CP0Character.h"
+#include "Weapon.h"
+#include "WeaponComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Anim Time (ms)"), STAT_AnimBudget_Ms, STATGROUP_CP0AnimBudget);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Evaluations"), STAT_AnimBudget_Evaluations, STATGROUP_CP0AnimBudget);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pressure"), STAT_AnimBudget_Pressure, STATGROUP_CP0AnimBudget);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Reduced Characters"), STAT_AnimBudget_Reduced, STATGROUP_CP0AnimBudget);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Skipped Updates / Frame"), STAT_AnimBudget_Skipped, STATGROUP_CP0AnimBudget);
+
+namespace
+{
+	float GAnimBudgetMs = 2.0f;
+	FAutoConsoleVariableRef CVarAnimBudgetMs{
+		TEXT("CP0.AnimBudgetMs"), GAnimBudgetMs,
+		TEXT("CPU time per frame that CP0 anim instances may spend before other characters' animation is reduced.")
+	};
+
+	// 중요도별 기본 갱신 간격 (프레임)
+	constexpr int32 BaseRates[static_cast<int32>(ESignificance::Num)]{1, 2, 4, 8};
+
+	int32 GetRate(ESignificance Significance, int32 Pressure)
+	{
+		// 압력이 오르면 Hidden부터 한 단계씩 더 낮춘다
+		const auto Tier = static_cast<int32>(Significance);
+		const auto Shift = FMath::Max(Pressure - (static_cast<int32>(ESignificance::Num) - 1 - Tier), 0);
+		return FMath::Min(BaseRates[Tier] << Shift, UAnimBudgetSubsystem::MaxUpdateRate);
+	}
+}
+
+void FBudgetedAnimInstanceProxy::Initialize(UAnimInstance* InAnimInstance)
+{
+	Super::Initialize(InAnimInstance);
+	BudgetCounter = UAnimBudgetSubsystem::GetCounter(InAnimInstance->GetWorld());
+}
+
+void FBudgetedAnimInstanceProxy::UpdateAnimationNode(const FAnimationUpdateContext& InContext)
+{
+	const auto Start = FPlatformTime::Cycles64();
+	Super::UpdateAnimationNode(InContext);
+
+	if (BudgetCounter)
+		BudgetCounter->Cycles += FPlatformTime::Cycles64() - Start;
+}
+
+void FBudgetedAnimInstanceProxy::EvaluateAnimationNode(FPoseContext& Output)
+{
+	const auto Start = FPlatformTime::Cycles64();
+	Super::EvaluateAnimationNode(Output);
+
+	if (BudgetCounter)
+	{
+		BudgetCounter->Cycles += FPlatformTime::Cycles64() - Start;
+		++BudgetCounter->Evaluations;
+	}
+}
+
+FAnimBudgetCounter* UAnimBudgetSubsystem::GetCounter(const UWorld* World)
+{
+	const auto Subsystem = World ? World->GetSubsystem<UAnimBudgetSubsystem>() : nullptr;
+	return Subsystem ? &Subsystem->Counter : nullptr;
+}
+
+void UAnimBudgetSubsystem::SetUpdateRate(USkeletalMeshComponent* Mesh, int32 Rate)
+{
+	const auto Params = Mesh ? Mesh->AnimUpdateRateParams : nullptr;
+	if (!Params)
+		return;
+
+	// 거리 대신 LOD 맵을 쓰게 하고 모든 LOD에 같은 값을 넣어서 여기서 정한 빈도를 그대로 따르게 한다
+	Params->bShouldUseLodMap = true;
+	Params->bInterpolateSkippedFrames = true;
+	Params->MaxEvalRateForInterpolation = MaxUpdateRate;
+	Params->BaseNonRenderedUpdateRate = Rate;
+	Params->LODToFrameSkipMap.Reset();
+	for (auto Lod = 0; Lod < MAX_SKELETAL_MESH_LODS; ++Lod)
+		Params->LODToFrameSkipMap.Add(Lod, Rate - 1);
+}
+
+void UAnimBudgetSubsystem::Register(ACP0Character* Character)
+{
+	Characters.AddUnique(Character);
+	TimeUntilUpdate = 0.0f;
+}
+
+void UAnimBudgetSubsystem::Unregister(ACP0Character* Character)
+{
+	Characters.RemoveSingleSwap(Character, false);
+}
+
+bool UAnimBudgetSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// 서버의 몸 포즈는 히트박스이므로 건드리지 않는다
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UAnimBudgetSubsystem::Tick(float DeltaTime)
+{
+	UpdatePressure(DeltaTime);
+
+	TimeUntilUpdate -= DeltaTime;
+	if (TimeUntilUpdate <= 0.0f)
+	{
+		TimeUntilUpdate = UpdateInterval;
+		UpdateRates();
+	}
+
+	SET_DWORD_STAT(STAT_AnimBudget_Pressure, Pressure);
+	SET_DWORD_STAT(STAT_AnimBudget_Reduced, NumReduced);
+	SET_FLOAT_STAT(STAT_AnimBudget_Skipped, SkippedPerFrame);
+}
+
+TStatId UAnimBudgetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAnimBudgetSubsystem, STATGROUP_Tickables);
+}
+
+ETickableTickType UAnimBudgetSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+void UAnimBudgetSubsystem::UpdatePressure(float DeltaTime)
+{
+	const auto Ms = static_cast<float>(FPlatformTime::ToMilliseconds64(Counter.Cycles.Exchange(0)));
+	const auto Evaluations = Counter.Evaluations.Exchange(0);
+	AvgMs = FMath::Lerp(AvgMs, Ms, 0.1f);
+
+	SET_FLOAT_STAT(STAT_AnimBudget_Ms, Ms);
+	SET_DWORD_STAT(STAT_AnimBudget_Evaluations, Evaluations);
+
+	TimeSincePressureChange += DeltaTime;
+	if (TimeSincePressureChange < PressureInterval)
+		return;
+
+	// 경계에서 오르내리기를 반복하지 않도록 내릴 때는 여유를 둔다
+	auto NewPressure = Pressure;
+	if (AvgMs > GAnimBudgetMs)
+		NewPressure = FMath::Min(Pressure + 1, MaxPressure);
+	else if (AvgMs < GAnimBudgetMs * 0.6f)
+		NewPressure = FMath::Max(Pressure - 1, 0);
+
+	if (NewPressure != Pressure)
+	{
+		Pressure = NewPressure;
+		TimeSincePressureChange = 0.0f;
+		TimeUntilUpdate = 0.0f;
+	}
+}
+
+void UAnimBudgetSubsystem::UpdateRates()
+{
+	Characters.RemoveAllSwap([](const TWeakObjectPtr<ACP0Character>& Character) { return !Character.IsValid(); },
+	                         false);
+
+	NumReduced = 0;
+	SkippedPerFrame = 0.0f;
+	for (const auto& Ptr : Characters)
+	{
+		const auto Character = Ptr.Get();
+
+		// 관전 중이거나 빙의되어 프록시가 아니게 된 캐릭터는 중요도가 High로 고정된다
+		const auto Rate = Character->GetLocalRole() == ROLE_SimulatedProxy
+			                  ? GetRate(Character->GetSignificance(), Pressure)
+			                  : 1;
+
+		// 몸과 팔은 둘 다 URO를 켰고 같은 액터라 엔진에서 같은 빈도 설정을 공유한다
+		SetUpdateRate(Character->GetMesh(), Rate);
+		SetUpdateRate(Character->GetArms(), Rate);
+
+		const auto Weapon = Character->GetWeaponComp()->GetWeapon();
+		if (Weapon && Weapon->GetMesh())
+			SetUpdateRate(Weapon->GetMesh(), Rate);
+
+		if (Rate > 1)
+		{
+			++NumReduced;
+			SkippedPerFrame += 1.0f - 1.0f / Rate;
+		}
+	}
+}
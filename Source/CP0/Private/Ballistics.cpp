@@ -0,0 +1,195 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#include "Ballistics.h"
+#include "LagCompensation.h"
+#include "Weapon.h"
+
+void UBallisticsSubsystem::Launch(AWeapon* Weapon, const FVector& Origin, const FVector& Velocity, float InDrag,
+                                  float Range, float TimeOffset, float InRewindTime)
+{
+	const auto Idx = NumRounds++;
+	const auto NumPadded = GetNumPadded();
+	for (auto& Lane : Lanes)
+		Lane.SetNumZeroed(NumPadded, false);
+
+	Lanes[PosX][Idx] = Origin.X;
+	Lanes[PosY][Idx] = Origin.Y;
+	Lanes[PosZ][Idx] = Origin.Z;
+	Lanes[VelX][Idx] = Velocity.X;
+	Lanes[VelY][Idx] = Velocity.Y;
+	Lanes[VelZ][Idx] = Velocity.Z;
+	Lanes[Drag][Idx] = InDrag;
+	Lanes[StepTime][Idx] = TimeOffset;
+
+	RangeLeft.Add(Range);
+	Age.Add(0.0f);
+	RewindTime.Add(InRewindTime);
+	Weapons.Add(Weapon);
+	Instigators.Add(Weapon->GetOwner());
+	Traces.AddDefaulted();
+	TraceTimes.Add(0.0f);
+}
+
+void UBallisticsSubsystem::Tick(float DeltaTime)
+{
+	const auto World = GetWorld();
+	Resolve(DeltaTime);
+	Integrate(DeltaTime, World->GetGravityZ());
+	RequestTraces(World->GetTimeSeconds());
+}
+
+TStatId UBallisticsSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBallisticsSubsystem, STATGROUP_Tickables);
+}
+
+ETickableTickType UBallisticsSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+FCollisionQueryParams UBallisticsSubsystem::MakeQueryParams(const AWeapon* Weapon, const AActor* Instigator)
+{
+	FCollisionQueryParams Params{TEXT("Ballistics"), true};
+	Params.AddIgnoredActor(Weapon);
+	Params.AddIgnoredActor(Instigator);
+	return Params;
+}
+
+void UBallisticsSubsystem::Resolve(float DeltaTime)
+{
+	const auto World = GetWorld();
+	const auto LagComp = World->GetSubsystem<ULagCompensationSubsystem>();
+
+	// 뒤에서부터 순회하므로 제거할 때 맨 뒤의 탄(이미 처리됨)과 바꿔도 된다
+	for (auto i = NumRounds - 1; i >= 0; --i)
+	{
+		// 지난 틱 이후에 발사되어 검사할 구간이 없다. 첫 적분 시간은 Launch에서 정했다
+		if (!Traces[i].IsValid())
+			continue;
+
+		const FVector Start{Lanes[PrevX][i], Lanes[PrevY][i], Lanes[PrevZ][i]};
+		const FVector End{Lanes[PosX][i], Lanes[PosY][i], Lanes[PosZ][i]};
+		const auto Weapon = Weapons[i].Get();
+		const auto Instigator = Instigators[i].Get();
+
+		FHitResult Hit;
+		auto bBlocked = false;
+		FTraceDatum Datum;
+		if (World->QueryTraceData(Traces[i], Datum))
+		{
+			bBlocked = Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit;
+			if (bBlocked)
+				Hit = Datum.OutHits[0];
+		}
+		else
+		{
+			// 결과를 잃었으면 (요청한 프레임을 건너뛴 경우 등) 직접 검사
+			bBlocked = World->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility,
+			                                           MakeQueryParams(Weapon, Instigator));
+		}
+		Traces[i].Invalidate();
+
+		// 캐릭터는 Visibility 채널을 무시하므로 지형지물 앞까지만 히트박스를 검사. 구간을 요청한 시각 기준으로 되감는다
+		auto bHitChar = false;
+		if (LagComp)
+		{
+			bHitChar = LagComp->Trace(Start, bBlocked ? Hit.Location : End, TraceTimes[i] - RewindTime[i],
+			                          Instigator, Hit);
+		}
+
+		const auto bHit = bBlocked || bHitChar;
+
+		if (bHit && Weapon)
+		{
+			// 발사 기록은 Launch할 때 남겼으므로 여기서는 캐릭터 명중만
+			Weapon->OnFireHit(Hit);
+			if (bHitChar)
+				Weapon->Audit(EHitAuditEvent::Hit, TraceTimes[i], &Hit);
+		}
+
+		if (bHit || RangeLeft[i] <= 0.0f || Age[i] >= MaxLifetime)
+			RemoveRound(i);
+		else
+			Lanes[StepTime][i] = DeltaTime;
+	}
+}
+
+void UBallisticsSubsystem::Integrate(float DeltaTime, float GravityZ)
+{
+	const auto NumPadded = GetNumPadded();
+	FMemory::Memcpy(Lanes[PrevX].GetData(), Lanes[PosX].GetData(), NumPadded * sizeof(float));
+	FMemory::Memcpy(Lanes[PrevY].GetData(), Lanes[PosY].GetData(), NumPadded * sizeof(float));
+	FMemory::Memcpy(Lanes[PrevZ].GetData(), Lanes[PosZ].GetData(), NumPadded * sizeof(float));
+
+	const auto Gravity = VectorSetFloat1(GravityZ);
+	const auto Epsilon = VectorSetFloat1(SMALL_NUMBER);
+	const auto One = VectorOne();
+	const auto Zero = VectorZero();
+
+	for (auto i = 0; i < NumPadded; i += 4)
+	{
+		const auto T = VectorLoadAligned(&Lanes[StepTime][i]);
+		const auto K = VectorLoadAligned(&Lanes[Drag][i]);
+		auto VX = VectorLoadAligned(&Lanes[VelX][i]);
+		auto VY = VectorLoadAligned(&Lanes[VelY][i]);
+		auto VZ = VectorLoadAligned(&Lanes[VelZ][i]);
+
+		// |v| = |v|^2 * rsqrt(|v|^2). 0으로 나누지 않도록 아주 작은 값을 더함
+		const auto SpeedSq = VectorMultiplyAdd(VX, VX, VectorMultiplyAdd(VY, VY, VectorMultiplyAdd(VZ, VZ, Epsilon)));
+		const auto Speed = VectorMultiply(SpeedSq, VectorReciprocalSqrt(SpeedSq));
+
+		// 반암시적 오일러: 속도를 먼저 갱신하고 그 속도로 위치를 옮긴다
+		const auto Damp = VectorMax(VectorSubtract(One, VectorMultiply(VectorMultiply(K, Speed), T)), Zero);
+		VX = VectorMultiply(VX, Damp);
+		VY = VectorMultiply(VY, Damp);
+		VZ = VectorMultiplyAdd(Gravity, T, VectorMultiply(VZ, Damp));
+
+		VectorStoreAligned(VX, &Lanes[VelX][i]);
+		VectorStoreAligned(VY, &Lanes[VelY][i]);
+		VectorStoreAligned(VZ, &Lanes[VelZ][i]);
+
+		VectorStoreAligned(VectorMultiplyAdd(VX, T, VectorLoadAligned(&Lanes[PosX][i])), &Lanes[PosX][i]);
+		VectorStoreAligned(VectorMultiplyAdd(VY, T, VectorLoadAligned(&Lanes[PosY][i])), &Lanes[PosY][i]);
+		VectorStoreAligned(VectorMultiplyAdd(VZ, T, VectorLoadAligned(&Lanes[PosZ][i])), &Lanes[PosZ][i]);
+	}
+}
+
+void UBallisticsSubsystem::RequestTraces(float Now)
+{
+	// 월드의 비동기 트레이스 버퍼가 모든 탄의 요청을 모아서 프레임의 나머지 작업과 병렬로 처리한다
+	const auto World = GetWorld();
+	for (auto i = 0; i < NumRounds; ++i)
+	{
+		const FVector Start{Lanes[PrevX][i], Lanes[PrevY][i], Lanes[PrevZ][i]};
+		const FVector End{Lanes[PosX][i], Lanes[PosY][i], Lanes[PosZ][i]};
+		Age[i] += Lanes[StepTime][i];
+		RangeLeft[i] -= FVector::Dist(Start, End);
+
+		TraceTimes[i] = Now;
+		Traces[i] = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, ECC_Visibility,
+		                                           MakeQueryParams(Weapons[i].Get(), Instigators[i].Get()));
+	}
+}
+
+void UBallisticsSubsystem::RemoveRound(int32 Idx)
+{
+	const auto Last = --NumRounds;
+	for (auto& Lane : Lanes)
+	{
+		Lane[Idx] = Lane[Last];
+		Lane[Last] = 0.0f;
+	}
+
+	const auto NumPadded = GetNumPadded();
+	for (auto& Lane : Lanes)
+		Lane.SetNum(NumPadded, false);
+
+	RangeLeft.RemoveAtSwap(Idx, 1, false);
+	Age.RemoveAtSwap(Idx, 1, false);
+	RewindTime.RemoveAtSwap(Idx, 1, false);
+	Weapons.RemoveAtSwap(Idx, 1, false);
+	Instigators.RemoveAtSwap(Idx, 1, false);
+	Traces.RemoveAtSwap(Idx, 1, false);
+	TraceTimes.RemoveAtSwap(Idx, 1, false);
+}
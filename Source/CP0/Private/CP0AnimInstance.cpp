@@ -4,29 +4,50 @@
 #include "CP0Character.h"
 #include "CP0CharacterMovement.h"
 
-void UCP0AnimInstance::NativeUpdateAnimation(float DeltaSeconds)
+void FCP0AnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
 {
-	Super::NativeUpdateAnimation(DeltaSeconds);
+	Super::PreUpdate(InAnimInstance, DeltaSeconds);
 
-	const auto* const Character = CastChecked<ACP0Character>(TryGetPawnOwner(), ECastCheckedType::NullAllowed);
+	const auto* const Character = CastChecked<ACP0Character>(InAnimInstance->TryGetPawnOwner(),
+	                                                         ECastCheckedType::NullAllowed);
+	bHasCharacter = Character != nullptr;
 	if (!Character)
 		return;
 
-	const auto Velocity = Character->GetVelocity();
-	MoveSpeed = Velocity.Size2D();
-	MoveDirection = CalculateDirection(Velocity, Character->GetActorRotation());
-
-	const auto AimRot = Character->GetBaseAimRotation() - Character->GetActorRotation();
-	AimPitch = FRotator::NormalizeAxis(AimRot.Pitch);
-	AimYaw = FRotator::NormalizeAxis(AimRot.Yaw);
-
 	const auto* const Movement = Character->GetCP0Movement();
+	Velocity = Character->GetVelocity();
+	ActorRotation = Character->GetActorRotation();
+	AimRotation = Character->GetBaseAimRotation();
+	MeshPitchOffset = Movement->GetMeshPitchOffset();
 	Posture = Movement->GetPosture();
 	bIsOnGround = Movement->IsMovingOnGround();
 	bIsSprinting = Movement->IsActuallySprinting();
-	bShouldPlayPostureAnim = MoveSpeed < 50.0f || Movement->IsProneSwitching();
-	MeshRotOffset.Roll = FMath::FInterpTo(MeshRotOffset.Roll, Movement->GetMeshPitchOffset(), DeltaSeconds,
-	                                      Movement->IsProneSwitching() ? 1.0f : 10.0f);
+	bIsProneSwitching = Movement->IsProneSwitching();
+}
+
+void FCP0AnimInstanceProxy::Update(float DeltaSeconds)
+{
+	Super::Update(DeltaSeconds);
+
+	if (!bHasCharacter)
+		return;
+
+	// 인스턴스의 변수는 게임 스레드에서 건드리지 않으므로 여기서 바로 쓴다
+	const auto Instance = CastChecked<UCP0AnimInstance>(GetAnimInstanceObject());
+
+	Instance->MoveSpeed = Velocity.Size2D();
+	Instance->MoveDirection = Instance->CalculateDirection(Velocity, ActorRotation);
+
+	const auto AimRot = AimRotation - ActorRotation;
+	Instance->AimPitch = FRotator::NormalizeAxis(AimRot.Pitch);
+	Instance->AimYaw = FRotator::NormalizeAxis(AimRot.Yaw);
+
+	Instance->Posture = Posture;
+	Instance->bIsOnGround = bIsOnGround;
+	Instance->bIsSprinting = bIsSprinting;
+	Instance->bShouldPlayPostureAnim = Instance->MoveSpeed < 50.0f || bIsProneSwitching;
+	Instance->MeshRotOffset.Roll = FMath::FInterpTo(Instance->MeshRotOffset.Roll, MeshPitchOffset, DeltaSeconds,
+	                                                bIsProneSwitching ? 1.0f : 10.0f);
 
 	constexpr auto YawCalcDelay = 1.0f / 10.0f;
 	YawCalcLag += DeltaSeconds;
@@ -36,8 +57,13 @@ void UCP0AnimInstance::NativeUpdateAnimation(float DeltaSeconds)
 		const auto SkippedTime = YawCalcDelay * SkippedFrames;
 		YawCalcLag -= SkippedTime;
 
-		const auto Yaw = Character->GetActorRotation().Yaw;
-		YawSpeed = MoveSpeed < 10.0f ? FMath::FindDeltaAngleDegrees(PrevYaw, Yaw) / SkippedTime : 0.0f;
+		const auto Yaw = ActorRotation.Yaw;
+		Instance->YawSpeed = Instance->MoveSpeed < 10.0f ? FMath::FindDeltaAngleDegrees(PrevYaw, Yaw) / SkippedTime : 0.0f;
 		PrevYaw = Yaw;
 	}
 }
+
+FAnimInstanceProxy* UCP0AnimInstance::CreateAnimInstanceProxy()
+{
+	return new FCP0AnimInstanceProxy{this};
+}
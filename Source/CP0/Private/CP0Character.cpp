@@ -1,15 +1,20 @@
 // (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
 
 #include "CP0Character.h"
+#include "AnimBudget.h"
 #include "CP0.h"
 #include "CP0CharacterMovement.h"
 #include "CP0GameInstance.h"
 #include "CP0InputSettings.h"
+#include "CP0ReplicationGraph.h"
+#include "CharacterUpdate.h"
 #include "Weapon.h"
 #include "WeaponComponent.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
+#include "GameFramework/PlayerController.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
 template <class...>
 using TBool = bool;
@@ -92,7 +97,7 @@ struct FInputAction
     }
 
 static const FInputAction InputActions[]{
-	MAKE_INPUT_ACTION(Sprint, true), MAKE_INPUT_ACTION(Crouch, true), MAKE_INPUT_ACTION(Prone, true),
+	MAKE_INPUT_ACTION(Sprint, false), MAKE_INPUT_ACTION(Crouch, false), MAKE_INPUT_ACTION(Prone, false),
 	MAKE_INPUT_ACTION(WalkSlow, false), MAKE_INPUT_ACTION(Fire, false), MAKE_INPUT_ACTION(Aim, true),
 	MAKE_INPUT_ACTION(Reload, true), MAKE_INPUT_ACTION(SwitchFiremode, true),
 };
@@ -107,21 +112,44 @@ static_assert(Size(InputActions) <= MAX_uint8, "Too many input actions");
 
 #undef MAKE_INPUT_ACTION
 
+// 데디케이티드 서버 빌드에서는 화면에만 쓰이는 컴포넌트를 아예 만들지 않는다. 이들을 쓰는 곳은 모두 null을 확인해야 함
+static const FObjectInitializer& StripCharacterCosmetics(const FObjectInitializer& Initializer)
+{
+#if UE_SERVER
+	return Initializer.DoNotCreateDefaultSubobject(TEXT("Camera"))
+	                  .DoNotCreateDefaultSubobject(TEXT("LegsMesh"))
+	                  .DoNotCreateDefaultSubobject(TEXT("ArmsMesh"));
+#else
+	return Initializer;
+#endif
+}
+
 ACP0Character::ACP0Character(const FObjectInitializer& Initializer)
-	: Super{Initializer.SetDefaultSubobjectClass<UCP0CharacterMovement>(CharacterMovementComponentName)},
-	  Camera{CreateDefaultSubobject<UCameraComponent>(TEXT("Camera"))},
+	: Super{
+		  StripCharacterCosmetics(Initializer).SetDefaultSubobjectClass<UCP0CharacterMovement>(CharacterMovementComponentName)
+	  },
+	  Camera{CreateOptionalDefaultSubobject<UCameraComponent>(TEXT("Camera"))},
 	  WeaponComp{CreateDefaultSubobject<UWeaponComponent>(TEXT("WeaponComp"))},
-	  LegsMesh{CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("LegsMesh"))},
-	  ArmsMesh{CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("ArmsMesh"))}
+	  LegsMesh{CreateOptionalDefaultSubobject<USkeletalMeshComponent>(TEXT("LegsMesh"))},
+	  ArmsMesh{CreateOptionalDefaultSubobject<USkeletalMeshComponent>(TEXT("ArmsMesh"))}
 {
 	PrimaryActorTick.bCanEverTick = true;
+	GetMesh()->bEnableUpdateRateOptimizations = true;
 	BaseEyeHeight = 150.0f;
 	CrouchedEyeHeight = 100.0f;
 	bUseControllerRotationYaw = false;
 
-	Camera->SetupAttachment(RootComponent);
-	LegsMesh->SetupAttachment(GetMesh());
-	ArmsMesh->SetupAttachment(RootComponent);
+	if (Camera)
+		Camera->SetupAttachment(RootComponent);
+
+	if (LegsMesh)
+		LegsMesh->SetupAttachment(GetMesh());
+
+	if (ArmsMesh)
+	{
+		ArmsMesh->SetupAttachment(RootComponent);
+		ArmsMesh->bEnableUpdateRateOptimizations = true;
+	}
 }
 
 UCP0CharacterMovement* ACP0Character::GetCP0Movement() const
@@ -134,28 +162,71 @@ bool ACP0Character::IsMoveInputIgnored() const
 	return GetCP0Movement()->IsProneSwitching() || Super::IsMoveInputIgnored();
 }
 
-static constexpr auto AngleCompressRatio = (1 << 16) / 360.0f;
+static constexpr auto PitchBits = 15;
+static constexpr auto PitchCompressRatio = ((1 << PitchBits) - 1) / 180.0f;
+static constexpr auto YawCompressRatio = (1 << 16) / 360.0f;
+
+FRemoteViewRotation FRemoteViewRotation::Compress(const FRotator& Rotation)
+{
+	const auto ViewPitch = FMath::Clamp(FRotator::NormalizeAxis(Rotation.Pitch), -90.0f, 90.0f);
+
+	FRemoteViewRotation Compressed;
+	Compressed.Pitch = static_cast<uint16>(FMath::RoundToInt((ViewPitch + 90.0f) * PitchCompressRatio));
+	Compressed.Yaw = static_cast<uint16>(FRotator::ClampAxis(Rotation.Yaw) * YawCompressRatio);
+	return Compressed;
+}
+
+FRotator FRemoteViewRotation::Decompress() const
+{
+	return {Pitch / PitchCompressRatio - 90.0f, Yaw / YawCompressRatio, 0.0f};
+}
+
+bool FRemoteViewRotation::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	// Pitch 15 | Yaw 16
+	uint32 Packed = 0;
+	if (Ar.IsSaving())
+		Packed = (Pitch & 0x7FFF) | Yaw << PitchBits;
+
+	Ar.SerializeBits(&Packed, PitchBits + 16);
+
+	if (Ar.IsLoading())
+	{
+		Pitch = Packed & 0x7FFF;
+		Yaw = Packed >> PitchBits & 0xFFFF;
+	}
+
+	bOutSuccess = true;
+	return true;
+}
 
 FRotator ACP0Character::GetBaseAimRotation() const
 {
 	if (Controller)
 		return Controller->GetControlRotation();
 
-	return {RemoteViewPitch16 / AngleCompressRatio, RemoteViewYaw16 / AngleCompressRatio, 0.0f};
+	return RemoteViewRotation.Decompress();
 }
 
 FRotator ACP0Character::GetViewRotation() const
 {
 	auto Rotation = Super::GetViewRotation();
-	Rotation += ArmsMesh->GetSocketRotation(TEXT("CameraSocket")) - ArmsMesh->GetComponentRotation();
+	if (ArmsMesh)
+		Rotation += ArmsMesh->GetSocketRotation(TEXT("CameraSocket")) - ArmsMesh->GetComponentRotation();
 	Rotation.Roll = 0.0f;
 	return Rotation;
 }
 
 void ACP0Character::SetRemoteViewRotation(FRotator Rotation)
 {
-	RemoteViewPitch16 = static_cast<uint16>(FRotator::ClampAxis(Rotation.Pitch) * AngleCompressRatio);
-	RemoteViewYaw16 = static_cast<uint16>(FRotator::ClampAxis(Rotation.Yaw) * AngleCompressRatio);
+	const auto Compressed = FRemoteViewRotation::Compress(Rotation);
+
+	// 조준이 그대로면 더티 표시를 하지 않아서 비교조차 하지 않게 한다
+	if (Compressed != RemoteViewRotation)
+	{
+		RemoteViewRotation = Compressed;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ACP0Character, RemoteViewRotation, this);
+	}
 }
 
 void ACP0Character::SetEyeHeight(float NewEyeHeight)
@@ -165,19 +236,9 @@ void ACP0Character::SetEyeHeight(float NewEyeHeight)
 
 void ACP0Character::SetEyeHeightWithBlend(float NewEyeHeight, float BlendTime)
 {
-	TargetEyeHeight = NewEyeHeight;
-	EyeHeightBlendTime = BlendTime;
-	PrevEyeHeight = GetEyeHeight();
-
-	if (BlendTime > KINDA_SMALL_NUMBER)
-	{
-		EyeHeightAlpha = 0.0f;
-	}
-	else
-	{
-		EyeHeightAlpha = 1.0f;
+	const auto Updater = GetWorld()->GetSubsystem<UCharacterUpdateSubsystem>();
+	if (!Updater || !Updater->BlendEyeHeight(this, NewEyeHeight, BlendTime))
 		SetEyeHeight(NewEyeHeight);
-	}
 }
 
 float ACP0Character::GetDefaultEyeHeight(EPosture Posture) const
@@ -198,19 +259,128 @@ float ACP0Character::GetEyeHeight() const
 	return BaseEyeHeight + GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
 }
 
+void ACP0Character::SetSignificance(ESignificance NewSignificance)
+{
+	if (Significance == NewSignificance)
+		return;
+
+	Significance = NewSignificance;
+
+	static constexpr float TickIntervals[]{0.0f, 1.0f / 30.0f, 1.0f / 10.0f, 1.0f / 4.0f};
+	static_assert(Size(TickIntervals) == static_cast<size_t>(ESignificance::Num), "Missing tick interval");
+
+	// 이동 컴포넌트는 비동기 트레이스를 다음 프레임에 읽어야 하므로 매 프레임 돌리고, 트레이스 요청만 줄인다
+	const auto Interval = TickIntervals[static_cast<uint8>(NewSignificance)];
+	GetCP0Movement()->SetCosmeticTraces(NewSignificance <= ESignificance::Medium, Interval);
+
+	// 다른 플레이어의 1인칭 팔은 가까이서 볼 때만 갱신
+	const auto bArms = ArmsMesh && NewSignificance == ESignificance::High;
+	if (ArmsMesh)
+		ArmsMesh->SetComponentTickEnabled(bArms);
+
+	if (const auto Updater = GetWorld()->GetSubsystem<UCharacterUpdateSubsystem>())
+		Updater->SetUpdateRate(this, Interval, bArms);
+}
+
+void ACP0Character::UpdateLegs()
+{
+	if (!LegsMesh)
+		return;
+
+	// 다리는 1인칭 화면에만 보이므로 다른 캐릭터의 다리는 아예 돌리지 않는다
+	const auto bLocal = IsLocallyControlled() && IsPlayerControlled() && !IsNetMode(NM_DedicatedServer);
+	LegsMesh->SetVisibility(bLocal);
+	LegsMesh->SetComponentTickEnabled(bLocal);
+
+	if (const auto Updater = GetWorld()->GetSubsystem<UCharacterUpdateSubsystem>())
+		Updater->SetLegsEnabled(this, bLocal);
+
+	if (!bLegsFollowBodyPose)
+		return;
+
+	if (bLocal)
+	{
+		// 몸이 자기 화면에 그려지지 않아도 본을 갱신해야 다리가 따라간다
+		GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+		LegsMesh->SetMasterPoseComponent(GetMesh());
+	}
+	else
+	{
+		LegsMesh->SetMasterPoseComponent(nullptr);
+	}
+}
+
+void ACP0Character::UpdateActorTickEnabled()
+{
+	// 꾸밈용 갱신은 UCharacterUpdateSubsystem이 하므로, 액터 틱은 입력 캡처(로컬)와 업데이트 빈도 조절(서버)에만 필요
+	SetActorTickEnabled(GetLocalRole() != ROLE_SimulatedProxy);
+}
+
 void ACP0Character::BeginPlay()
 {
 	Super::BeginPlay();
 	SetEyeHeight(BaseEyeHeight);
+
+	if (const auto Updater = GetWorld()->GetSubsystem<UCharacterUpdateSubsystem>())
+		Updater->Register(this);
+
+	UpdateActorTickEnabled();
+	UpdateLegs();
+
+	// 애니메이션 빈도는 다른 플레이어의 캐릭터만 낮춘다. 서버에서는 몸 포즈가 곧 히트박스
+	UAnimBudgetSubsystem::SetUpdateRate(GetMesh(), 1);
+
+	if (GetLocalRole() == ROLE_SimulatedProxy)
+	{
+		if (const auto SignificanceSys = GetWorld()->GetSubsystem<USignificanceSubsystem>())
+			SignificanceSys->Register(this);
+
+		if (const auto AnimBudget = GetWorld()->GetSubsystem<UAnimBudgetSubsystem>())
+			AnimBudget->Register(this);
+	}
+
+	MaxNetUpdateFrequency = NetUpdateFrequency;
+
+	if (HasAuthority())
+	{
+		// 서버에서는 렌더링 여부와 관계없이 히트박스용 본 위치가 갱신되어야 함
+		GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+
+		// 일반 빌드로 데디케이티드 서버를 돌릴 때는 팔이 있지만 틱할 필요는 없다. 다리는 UpdateLegs에서 꺼짐
+		if (ArmsMesh && IsNetMode(NM_DedicatedServer))
+			ArmsMesh->SetComponentTickEnabled(false);
+
+		if (const auto LagComp = GetWorld()->GetSubsystem<ULagCompensationSubsystem>())
+			LagComp->Register(this);
+	}
+}
+
+void ACP0Character::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (const auto LagComp = GetWorld()->GetSubsystem<ULagCompensationSubsystem>())
+		LagComp->Unregister(this);
+
+	if (const auto SignificanceSys = GetWorld()->GetSubsystem<USignificanceSubsystem>())
+		SignificanceSys->Unregister(this);
+
+	if (const auto AnimBudget = GetWorld()->GetSubsystem<UAnimBudgetSubsystem>())
+		AnimBudget->Unregister(this);
+
+	if (const auto Updater = GetWorld()->GetSubsystem<UCharacterUpdateSubsystem>())
+		Updater->Unregister(this);
+
+	StopInputCapture();
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ACP0Character::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
-	InterpEyeHeight(DeltaTime);
-	UpdateLegsTransform();
-	UpdateArmsTransform(DeltaTime);
-	Camera->SetWorldLocationAndRotation(GetPawnViewLocation(), GetViewRotation());
+	UpdateInputCapture(DeltaTime);
+
+	if (HasAuthority() && !IsNetMode(NM_Standalone))
+		UpdateNetUpdateFrequency(DeltaTime);
 }
 
 void ACP0Character::SetupPlayerInputComponent(UInputComponent* Input)
@@ -280,52 +450,156 @@ void ACP0Character::SetupPlayerInputComponent(UInputComponent* Input)
 	}
 }
 
-void ACP0Character::InterpEyeHeight(float DeltaTime)
+void ACP0Character::ApplyCapturedInput(const FInputCaptureFrame& Frame)
+{
+	if (Controller)
+		Controller->SetControlRotation({Frame.Pitch, Frame.Yaw, 0.0f});
+
+	MoveForward(Frame.Forward);
+	MoveRight(Frame.Right);
+
+	for (auto i = 0; i < FMath::Min<int32>(Frame.NumActions, FInputCaptureFrame::MaxActions); ++i)
+		DispatchInputAction(Frame.ActionIdx[i], static_cast<EInputAction>(Frame.ActionType[i]));
+
+	if (Frame.bJump)
+		Jump();
+}
+
+void ACP0Character::UpdateInputCapture(float DeltaTime)
+{
+	if (!IsLocallyControlled() || !IsPlayerControlled())
+		return;
+
+	if (FInputCapture::IsEnabled() != InputCapture.IsValid())
+	{
+		if (InputCapture)
+		{
+			StopInputCapture();
+		}
+		else
+		{
+			InputCapture = MakeUnique<FInputCapture>();
+			InputCapture->Header.StartLocation = GetActorLocation();
+			InputCapture->Header.StartRotation = GetActorRotation();
+			InputCapture->Header.StartPosture = GetCP0Movement()->GetPosture();
+		}
+	}
+
+	if (InputCapture)
+	{
+		// 입력은 컨트롤러 틱에서 이미 처리되었고, 이동 컴포넌트는 이 다음에 틱한다
+		const auto ControlRotation = GetControlRotation();
+		PendingInput.DeltaTime = DeltaTime;
+		PendingInput.Pitch = ControlRotation.Pitch;
+		PendingInput.Yaw = ControlRotation.Yaw;
+		PendingInput.bJump = bPressedJump;
+		InputCapture->Frames.Add(PendingInput);
+	}
+
+	PendingInput = {};
+}
+
+void ACP0Character::StopInputCapture()
 {
-	if (EyeHeightAlpha >= 1.0f)
+	if (!InputCapture)
 		return;
 
-	EyeHeightAlpha = FMath::Clamp(EyeHeightAlpha + DeltaTime / EyeHeightBlendTime, 0.0f, 1.0f);
-	SetEyeHeight(FMath::CubicInterp(PrevEyeHeight, 0.0f, TargetEyeHeight, 0.0f, EyeHeightAlpha));
+	InputCapture->Save(FInputCapture::MakeFilename());
+	InputCapture.Reset();
 }
 
-void ACP0Character::UpdateLegsTransform() const
+void ACP0Character::UpdateNetUpdateFrequency(float DeltaTime)
 {
-	const auto Default = GetDefault<ACP0Character>(GetClass())->LegsMesh;
-	const auto OffsetX = Default->GetRelativeLocation().Y;
+	const auto Movement = GetCP0Movement();
+	const auto Weapon = WeaponComp->GetWeapon();
+
+	const auto AimRot = GetBaseAimRotation();
+	const auto AimDelta = (AimRot - PrevNetAimRot).GetNormalized();
+	const auto AimSpeed = FMath::Max(FMath::Abs(AimDelta.Pitch), FMath::Abs(AimDelta.Yaw)) / FMath::Max(DeltaTime, SMALL_NUMBER);
+	PrevNetAimRot = AimRot;
+
+	ViewerDistanceAge -= DeltaTime;
+	if (ViewerDistanceAge <= 0.0f)
+	{
+		NearestViewerDistance = FindNearestViewerDistance();
+		ViewerDistanceAge = 0.5f;
+	}
+
+	const auto MaxSpeed = Movement->GetMaxSpeed();
+	const auto SpeedAlpha = MaxSpeed > 0.0f ? GetVelocity().Size() / MaxSpeed : 0.0f;
+	const auto AimAlpha = FullRateAimSpeed > 0.0f ? AimSpeed / FullRateAimSpeed : 1.0f;
+	auto Activity = FMath::Clamp(FMath::Max(SpeedAlpha, AimAlpha), 0.0f, 1.0f);
+	if (NearestViewerDistance > FarViewerDistance)
+		Activity *= 0.5f;
+
+	const auto bUrgent = Movement->IsActuallySprinting() || (Weapon && Weapon->IsFiring());
+	const auto Target = bUrgent ? MaxNetUpdateFrequency : FMath::Lerp(IdleNetUpdateFrequency, MaxNetUpdateFrequency, Activity);
+
+	// 올릴 때는 즉시, 내릴 때는 천천히. 낮은 빈도로 잡혀 있던 다음 업데이트를 기다리지 않도록 바로 보낸다
+	if (Target > NetUpdateFrequency)
+	{
+		if (Target >= NetUpdateFrequency * 2.0f)
+			ForceNetUpdate();
 
-	const FRotator ViewYaw{0.0f, GetBaseAimRotation().Yaw, 0.0f};
-	const auto BaseLoc = GetMesh()->GetComponentLocation();
+		NetUpdateFrequency = Target;
+	}
+	else
+	{
+		NetUpdateFrequency = FMath::FInterpTo(NetUpdateFrequency, Target, DeltaTime, 2.0f);
+	}
 
-	LegsMesh->SetWorldLocation(BaseLoc + ViewYaw.Vector() * OffsetX);
+	UCP0ReplicationGraph::SetNetUpdateFrequency(this, NetUpdateFrequency);
 }
 
-void ACP0Character::UpdateArmsTransform(float DeltaTime)
+struct FNetViewer
 {
-	const auto AimRot = GetBaseAimRotation().GetNormalized();
-	auto Diff = (PrevAimRot - AimRot).GetNormalized();
-	Diff.Yaw *= 1.0f - FMath::Abs(AimRot.Pitch) / 90.0f;
+	const AController* Controller;
+	FVector Location;
+};
+
+// 같은 프레임에 거리를 재는 캐릭터들이 함께 쓴다. 캐릭터마다 컨트롤러를 순회하며 시점 대상을 찾지 않도록
+static const TArray<FNetViewer>& GetNetViewers(UWorld* World)
+{
+	static TWeakObjectPtr<UWorld> CachedWorld;
+	static uint64 CachedFrame = 0;
+	static TArray<FNetViewer> Viewers;
+
+	if (CachedWorld != World || CachedFrame != GFrameCounter)
+	{
+		CachedWorld = World;
+		CachedFrame = GFrameCounter;
+		Viewers.Reset();
+		for (auto It = World->GetPlayerControllerIterator(); It; ++It)
+		{
+			const auto PC = It->Get();
+			if (const auto ViewTarget = PC ? PC->GetViewTarget() : nullptr)
+				Viewers.Add({PC, ViewTarget->GetActorLocation()});
+		}
+	}
 
-	AimRotSpeed = FMath::RInterpTo(AimRotSpeed, Diff, DeltaTime, 10.0f);
-	PrevAimRot = AimRot;
-	ArmsLocalOffset.SetRotation(FMath::QInterpTo(ArmsLocalOffset.GetRotation(), AimRotSpeed.Quaternion().Inverse(),
-	                                             DeltaTime, 10.0f));
+	return Viewers;
+}
 
-	const auto DefArms = GetDefault<ACP0Character>(GetClass())->ArmsMesh;
-	auto NewTF = DefArms->GetRelativeTransform();
-	if (const auto Weapon = WeaponComp->GetWeapon())
-		NewTF *= Weapon->ArmsOffset;
-	NewTF *= ArmsLocalOffset;
-	NewTF *= {AimRot, GetPawnViewLocation()};
-	ArmsMesh->SetWorldTransform(NewTF);
+float ACP0Character::FindNearestViewerDistance() const
+{
+	const auto Location = GetActorLocation();
+	auto MinDistSq = TNumericLimits<float>::Max();
+	for (const auto& Viewer : GetNetViewers(GetWorld()))
+	{
+		if (Viewer.Controller != Controller)
+			MinDistSq = FMath::Min(MinDistSq, FVector::DistSquared(Viewer.Location, Location));
+	}
+	return FMath::Sqrt(MinDistSq);
 }
 
 void ACP0Character::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME_CONDITION(ACP0Character, RemoteViewPitch16, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(ACP0Character, RemoteViewYaw16, COND_SkipOwner);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	Params.Condition = COND_SkipOwner;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ACP0Character, RemoteViewRotation, Params);
 }
 
 void ACP0Character::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
@@ -338,6 +612,26 @@ void ACP0Character::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTr
 	}
 }
 
+void ACP0Character::PawnClientRestart()
+{
+	Super::PawnClientRestart();
+	UpdateLegs();
+}
+
+void ACP0Character::UnPossessed()
+{
+	Super::UnPossessed();
+	UpdateLegs();
+}
+
+void ACP0Character::PostNetReceiveRole()
+{
+	Super::PostNetReceiveRole();
+
+	if (HasActorBegunPlay())
+		UpdateActorTickEnabled();
+}
+
 void ACP0Character::ServerInputAction_Implementation(uint8 Idx, EInputAction Type)
 {
 	DispatchInputAction(Idx, Type);
@@ -352,6 +646,13 @@ void ACP0Character::DispatchInputAction(size_t Idx, EInputAction Type)
 {
 	if (Idx < Size(InputActions))
 	{
+		if (InputCapture && PendingInput.NumActions < FInputCaptureFrame::MaxActions)
+		{
+			PendingInput.ActionIdx[PendingInput.NumActions] = static_cast<uint8>(Idx);
+			PendingInput.ActionType[PendingInput.NumActions] = static_cast<uint8>(Type);
+			++PendingInput.NumActions;
+		}
+
 		const auto bExecuted = InputActions[Idx].Dispatcher(this, Type);
 
 		if (bExecuted && InputActions[Idx].bSendToServer && !HasAuthority())
@@ -361,6 +662,8 @@ void ACP0Character::DispatchInputAction(size_t Idx, EInputAction Type)
 
 void ACP0Character::MoveForward(float AxisValue)
 {
+	PendingInput.Forward = AxisValue;
+
 	if (!FMath::IsNearlyZero(AxisValue))
 	{
 		const FRotator Rotation{0.0f, GetControlRotation().Yaw, 0.0f};
@@ -370,6 +673,8 @@ void ACP0Character::MoveForward(float AxisValue)
 
 void ACP0Character::MoveRight(float AxisValue)
 {
+	PendingInput.Right = AxisValue;
+
 	if (!FMath::IsNearlyZero(AxisValue))
 	{
 		const FRotator Rotation{0.0f, GetControlRotation().Yaw + 90.0f, 0.0f};
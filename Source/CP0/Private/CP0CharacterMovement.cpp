@@ -3,15 +3,144 @@
 #include "CP0CharacterMovement.h"
 #include "CP0.h"
 #include "CP0Character.h"
+#include "CP0PostureData.h"
 #include "Components/CapsuleComponent.h"
-#include "GameFramework/PlayerState.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "TerrainCache.h"
 #include "Weapon.h"
 #include "WeaponComponent.h"
 
+namespace
+{
+	FCollisionQueryParams MakeProneQueryParams(bool bDynamicOnly)
+	{
+		FCollisionQueryParams Params{SCENE_QUERY_STAT(ProneQuery), false};
+		if (bDynamicOnly)
+			Params.MobilityType = EQueryMobilityType::Dynamic;
+
+		return Params;
+	}
+}
+
+const TCHAR* const FMovementTimers::Names[FMovementTimers::Num]{
+	TEXT("TickComponent"), TEXT("StateBeforeMovement"), TEXT("TrySetPosture"), TEXT("PronePush"), TEXT("PronePitch")
+};
+
+bool FMovementTimers::bEnabled = false;
+uint64 FMovementTimers::Cycles[FMovementTimers::Num];
+uint32 FMovementTimers::Calls[FMovementTimers::Num];
+
+void FMovementTimers::Reset()
+{
+	FMemory::Memzero(Cycles);
+	FMemory::Memzero(Calls);
+}
+
+void FSavedMove_CP0::Clear()
+{
+	Super::Clear();
+	WantedPosture = EPosture::Stand;
+	bWantsToSprint = false;
+	bWalkingSlow = false;
+}
+
+uint8 FSavedMove_CP0::GetCompressedFlags() const
+{
+	auto Flags = Super::GetCompressedFlags();
+	Flags |= static_cast<uint8>(WantedPosture) << 4 & (FLAG_Custom_0 | FLAG_Custom_1);
+
+	if (bWantsToSprint)
+		Flags |= FLAG_Custom_2;
+
+	if (bWalkingSlow)
+		Flags |= FLAG_Custom_3;
+
+	return Flags;
+}
+
+bool FSavedMove_CP0::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	const auto& Other = static_cast<const FSavedMove_CP0&>(*NewMove);
+	if (WantedPosture != Other.WantedPosture || bWantsToSprint != Other.bWantsToSprint ||
+		bWalkingSlow != Other.bWalkingSlow)
+		return false;
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_CP0::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel,
+                                FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	const auto Movement = CastChecked<UCP0CharacterMovement>(C->GetCharacterMovement());
+	WantedPosture = Movement->GetWantedPosture();
+	bWantsToSprint = Movement->IsInSprintMode();
+	bWalkingSlow = Movement->IsWalkingSlow();
+}
+
+FNetworkPredictionData_Client_CP0::FNetworkPredictionData_Client_CP0(const UCharacterMovementComponent& ClientMovement)
+	: FNetworkPredictionData_Client_Character{ClientMovement}
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_CP0::AllocateNewMove()
+{
+	return FSavedMovePtr{new FSavedMove_CP0};
+}
+
+void FCP0MoveResponseDataContainer::ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement,
+                                                           const FClientAdjustment& PendingAdjustment)
+{
+	Super::ServerFillResponseData(CharacterMovement, PendingAdjustment);
+
+	const auto& Movement = static_cast<const UCP0CharacterMovement&>(CharacterMovement);
+	Posture = Movement.Posture;
+	PostureSwitchTimeLeft = Movement.PostureSwitchTimeLeft;
+	bSprinting = Movement.bSprinting;
+}
+
+bool FCP0MoveResponseDataContainer::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar,
+                                              UPackageMap* PackageMap)
+{
+	if (!Super::Serialize(CharacterMovement, Ar, PackageMap))
+		return false;
+
+	if (!IsGoodMove())
+	{
+		// Posture 2 | bSprinting 1 | bSwitching 1, 자세 전환 중일 때만 남은 시간을 밀리초 16비트로 보낸다
+		const auto bSwitching = PostureSwitchTimeLeft > 0.0f;
+		uint8 Bits = static_cast<uint8>(Posture) | bSprinting << 2 | bSwitching << 3;
+		Ar.SerializeBits(&Bits, 4);
+
+		uint16 SwitchTimeMs = 0;
+		if (Bits & 8)
+		{
+			if (Ar.IsSaving())
+			{
+				const auto Ms = FMath::CeilToInt(PostureSwitchTimeLeft * 1000.0f);
+				SwitchTimeMs = static_cast<uint16>(FMath::Clamp(Ms, 1, 0xFFFF));
+			}
+
+			Ar << SwitchTimeMs;
+		}
+
+		if (Ar.IsLoading())
+		{
+			Posture = static_cast<EPosture>(FMath::Min(Bits & 3, 2));
+			bSprinting = (Bits & 4) != 0;
+			PostureSwitchTimeLeft = SwitchTimeMs / 1000.0f;
+		}
+	}
+
+	return !Ar.IsError();
+}
+
 UCP0CharacterMovement::UCP0CharacterMovement()
 {
 	SetIsReplicatedByDefault(true);
+	SetMoveResponseDataContainer(MoveResponseData);
 
 	MaxAcceleration = 1024.0f;
 	GroundFriction = 6.0f;
@@ -37,15 +166,10 @@ float UCP0CharacterMovement::GetMaxSpeed() const
 	{
 	case MOVE_Walking:
 	case MOVE_NavWalking:
-		switch (Posture)
-		{
-		case EPosture::Stand:
-			return bSprinting ? 500.0f : MaxWalkSpeed;
-		case EPosture::Crouch:
-			return MaxWalkSpeedCrouched;
-		case EPosture::Prone:
-			return 100.0f;
-		}
+	{
+		const auto& Table = GetPostureTable();
+		return Posture == EPosture::Stand && bSprinting ? Table.SprintSpeed : Table.GetMaxSpeed(Posture);
+	}
 	default:
 		return Super::GetMaxSpeed();
 	}
@@ -53,15 +177,7 @@ float UCP0CharacterMovement::GetMaxSpeed() const
 
 float UCP0CharacterMovement::GetMaxAcceleration() const
 {
-	switch (Posture)
-	{
-	case EPosture::Crouch:
-		return 512.0f;
-	case EPosture::Prone:
-		return 256.0f;
-	default:
-		return MaxAcceleration;
-	}
+	return GetPostureTable().GetMaxAcceleration(Posture);
 }
 
 bool UCP0CharacterMovement::CanAttemptJump() const
@@ -71,7 +187,8 @@ bool UCP0CharacterMovement::CanAttemptJump() const
 
 bool UCP0CharacterMovement::IsActuallySprinting() const
 {
-	return bSprinting && IsMovingOnGround() && Velocity.SizeSquared2D() >= MaxWalkSpeed * MaxWalkSpeed;
+	const auto WalkSpeed = GetPostureTable().GetMaxSpeed(EPosture::Stand);
+	return bSprinting && IsMovingOnGround() && Velocity.SizeSquared2D() >= WalkSpeed * WalkSpeed;
 }
 
 bool UCP0CharacterMovement::CanSprint(bool bIgnorePosture) const
@@ -115,6 +232,7 @@ bool UCP0CharacterMovement::TryStartSprint()
 	case EPosture::Crouch:
 		if (!TrySetPosture(EPosture::Stand))
 			return false;
+		WantedPosture = EPosture::Stand;
 	default: ;
 	}
 
@@ -130,6 +248,8 @@ void UCP0CharacterMovement::StopSprint()
 
 bool UCP0CharacterMovement::TrySetPosture(EPosture New, ESetPostureCheckLevel CheckLevel)
 {
+	FMovementTimers::FScope Timer{FMovementTimers::TrySetPosture};
+
 	if (CheckLevel > SPCL_Correction && Posture == New)
 		return true;
 
@@ -190,7 +310,10 @@ bool UCP0CharacterMovement::TrySetPosture(EPosture New, ESetPostureCheckLevel Ch
 		}
 	}
 
-	Owner->SetEyeHeightWithBlend(Owner->GetDefaultEyeHeight(New), SwitchTime);
+	// 재생은 이미 보여준 전환을 다시 밟는 것이므로 시점 블렌드와 이벤트는 처음 예측할 때만
+	if (!bClientUpdating)
+		Owner->SetEyeHeightWithBlend(Owner->GetDefaultEyeHeight(New), SwitchTime);
+
 	Owner->BaseTranslationOffset = {0.0f, 0.0f, -NewHalfHeight};
 	Owner->GetMesh()->SetRelativeLocation(Owner->BaseTranslationOffset);
 	Capsule->SetCapsuleHalfHeight(NewHalfHeight);
@@ -212,12 +335,13 @@ bool UCP0CharacterMovement::TrySetPosture(EPosture New, ESetPostureCheckLevel Ch
 
 	if (CheckLevel > SPCL_Correction)
 	{
-		NextPostureSwitch = CurTime() + SwitchTime;
-		Owner->OnPostureChanged(PrevPosture, Posture);
+		PostureSwitchTimeLeft = SwitchTime;
+		if (!bClientUpdating)
+			Owner->OnPostureChanged(PrevPosture, Posture);
 	}
 	else
 	{
-		NextPostureSwitch = CurTime();
+		PostureSwitchTimeLeft = 0.0f;
 	}
 
 	return true;
@@ -225,63 +349,22 @@ bool UCP0CharacterMovement::TrySetPosture(EPosture New, ESetPostureCheckLevel Ch
 
 bool UCP0CharacterMovement::IsPostureSwitching() const
 {
-	return NextPostureSwitch > CurTime();
+	return PostureSwitchTimeLeft > 0.0f;
 }
 
 bool UCP0CharacterMovement::IsProneSwitching() const
 {
-	return NextPostureSwitch - 0.2f > CurTime() && (PrevPosture == EPosture::Prone || Posture == EPosture::Prone);
+	return PostureSwitchTimeLeft > 0.2f && (PrevPosture == EPosture::Prone || Posture == EPosture::Prone);
 }
 
-float UCP0CharacterMovement::GetPostureSwitchTime(EPosture Prev, EPosture New)
+float UCP0CharacterMovement::GetPostureSwitchTime(EPosture Prev, EPosture New) const
 {
-	switch (Prev)
-	{
-	case EPosture::Stand:
-		switch (New)
-		{
-		case EPosture::Crouch:
-			return 0.5f;
-		case EPosture::Prone:
-			return 1.5f;
-		default: ;
-		}
-		break;
-	case EPosture::Crouch:
-		switch (New)
-		{
-		case EPosture::Stand:
-			return 0.5f;
-		case EPosture::Prone:
-			return 1.0f;
-		default: ;
-		}
-		break;
-	case EPosture::Prone:
-		switch (New)
-		{
-		case EPosture::Stand:
-			return 1.8f;
-		case EPosture::Crouch:
-			return 1.2f;
-		default: ;
-		}
-		break;
-	}
-	return 0.0f;
+	return GetPostureTable().GetSwitchTime(Prev, New);
 }
 
 float UCP0CharacterMovement::GetDefaultHalfHeight(EPosture P) const
 {
-	switch (P)
-	{
-	case EPosture::Crouch:
-		return CrouchedHalfHeight;
-	case EPosture::Prone:
-		return 34.0f;
-	default:
-		return GetCharacterOwner()->GetDefaultHalfHeight();
-	}
+	return GetPostureTable().GetHalfHeight(P);
 }
 
 bool UCP0CharacterMovement::CanWalkSlow() const
@@ -298,33 +381,91 @@ bool UCP0CharacterMovement::TryStartWalkingSlow()
 	return true;
 }
 
-float UCP0CharacterMovement::CalcFloorPitch() const
+FNetworkPredictionData_Client* UCP0CharacterMovement::GetPredictionData_Client() const
 {
-	if (!CharacterOwner)
-		return 0.0f;
+	if (!ClientPredictionData)
+	{
+		const auto MutableThis = const_cast<UCP0CharacterMovement*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_CP0{*this};
+	}
+	return ClientPredictionData;
+}
 
+void UCP0CharacterMovement::SetCosmeticTraces(bool bEnabled, float Interval)
+{
+	bCosmeticTraces = bEnabled;
+	CosmeticTraceInterval = Interval;
+	TimeUntilCosmeticTrace = FMath::Min(TimeUntilCosmeticTrace, Interval);
+}
+
+void UCP0CharacterMovement::RequestFloorTraces()
+{
 	const auto World = GetWorld();
 	const auto Capsule = CharacterOwner->GetCapsuleComponent();
 	const auto BaseLoc = Capsule->GetComponentLocation();
 	const auto ForwardOffset = Capsule->GetForwardVector() * Capsule->GetScaledCapsuleRadius();
 	const FVector EndOffset{0.0f, 0.0f, -3.0f * Capsule->GetScaledCapsuleHalfHeight()};
 
-	FHitResult Front, Rear;
+	const auto Cache = World->GetSubsystem<UTerrainCacheSubsystem>();
+
+	const FVector Starts[]{BaseLoc + ForwardOffset, BaseLoc - ForwardOffset};
+	for (auto i = 0; i < 2; ++i)
+	{
+		auto End = Starts[i] + EndOffset;
+		float FloorZ;
+		auto& bStatic = ProneQuery.bStaticFloor[i];
+		bStatic = Cache && Cache->SampleHeight(Starts[i], PushTraceChannel, FloorZ) && FloorZ >= End.Z;
+
+		// 정적 바닥을 알면 그 위에 올라온 움직이는 물체만 찾으면 된다
+		if (bStatic)
+			End = ProneQuery.StaticFloor[i] = {End.X, End.Y, FloorZ};
+
+		ProneQuery.Floor[i] = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Starts[i], End, PushTraceChannel,
+		                                                     MakeProneQueryParams(bStatic));
+	}
+}
+
+bool UCP0CharacterMovement::ReadAsyncTrace(FTraceHandle& Handle, FHitResult& OutHit, bool& bOutBlocked) const
+{
+	FTraceDatum Datum;
+	if (!Handle.IsValid() || !GetWorld()->QueryTraceData(Handle, Datum))
+		return false;
 
-	const auto FrontLoc = BaseLoc + ForwardOffset;
-	if (!World->LineTraceSingleByChannel(Front, FrontLoc, FrontLoc + EndOffset, PushTraceChannel))
-		return 0.0f;
+	Handle.Invalidate();
+	bOutBlocked = Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit;
+	if (bOutBlocked)
+		OutHit = Datum.OutHits[0];
 
-	const auto RearLoc = BaseLoc - ForwardOffset;
-	if (!World->LineTraceSingleByChannel(Rear, RearLoc, RearLoc + EndOffset, PushTraceChannel))
-		return 0.0f;
+	return true;
+}
 
-	const auto HeightDiff = Rear.Location.Z - Front.Location.Z;
-	const auto NormalizedHeight = FMath::Abs(HeightDiff) / FVector::Dist(Front.Location, Rear.Location);
+float UCP0CharacterMovement::CalcFloorPitch(const FVector& Front, const FVector& Rear)
+{
+	const auto HeightDiff = Rear.Z - Front.Z;
+	const auto NormalizedHeight = FMath::Abs(HeightDiff) / FVector::Dist(Front, Rear);
 	const auto AbsRadians = FMath::FastAsin(NormalizedHeight);
 	return FMath::RadiansToDegrees(AbsRadians) * FMath::Sign(HeightDiff);
 }
 
+void UCP0CharacterMovement::PostInitProperties()
+{
+	Super::PostInitProperties();
+	BuildFallbackPostureData();
+}
+
+void UCP0CharacterMovement::PostLoad()
+{
+	Super::PostLoad();
+	BuildFallbackPostureData();
+}
+
+void UCP0CharacterMovement::InitializeComponent()
+{
+	Super::InitializeComponent();
+	GetPostureTable();
+	GetDefaultSelf();
+}
+
 void UCP0CharacterMovement::BeginPlay()
 {
 	Super::BeginPlay();
@@ -334,10 +475,15 @@ void UCP0CharacterMovement::BeginPlay()
 void UCP0CharacterMovement::TickComponent(float DeltaTime, ELevelTick TickType,
                                           FActorComponentTickFunction* ThisTickFunction)
 {
-	if (GetOwnerRole() != ROLE_SimulatedProxy && !IsMovingOnGround())
-		TrySetPosture(EPosture::Stand, SPCL_IgnoreDelay);
+	FMovementTimers::FScope Timer{FMovementTimers::TickComponent};
+
+	// 시뮬레이티드 프록시는 이동을 직접 수행하지 않으므로 여기서 자세 전환 시간을 흘려보낸다
+	if (GetOwnerRole() == ROLE_SimulatedProxy)
+		PostureSwitchTimeLeft = FMath::Max(PostureSwitchTimeLeft - DeltaTime, 0.0f);
+
+	if (IsActuallySprinting())
+		LastActualSprintTime = GetWorld()->GetTimeSeconds();
 
-	ProcessSprint();
 	ProcessPronePush();
 	ProcessSlowWalk();
 	UpdateRotationRate();
@@ -353,15 +499,19 @@ void UCP0CharacterMovement::TickComponent(float DeltaTime, ELevelTick TickType,
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
 	ProcessForceTurn();
-	CorrectClientState();
 }
 
 void UCP0CharacterMovement::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME_CONDITION(UCP0CharacterMovement, Posture, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(UCP0CharacterMovement, bSprinting, COND_SkipOwner);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	// 소유자는 이동 예측으로 직접 계산하고, 어긋나면 이동 보정과 함께 받는다
+	Params.Condition = COND_SkipOwner;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UCP0CharacterMovement, Posture, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(UCP0CharacterMovement, bSprinting, Params);
 }
 
 void UCP0CharacterMovement::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
@@ -392,75 +542,235 @@ bool UCP0CharacterMovement::DoJump(bool bReplayingMoves)
 {
 	if (Posture != EPosture::Stand)
 	{
+		WantedPosture = EPosture::Stand;
 		TrySetPosture(EPosture::Stand);
 		return false;
 	}
 	return Super::DoJump(bReplayingMoves);
 }
 
-float UCP0CharacterMovement::CurTime() const
+void UCP0CharacterMovement::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	WantedPosture = static_cast<EPosture>(FMath::Min(Flags >> 4 & 3, 2));
+	bWantsToSprint = (Flags & FSavedMove_Character::FLAG_Custom_2) != 0;
+	bWalkingSlow = (Flags & FSavedMove_Character::FLAG_Custom_3) != 0;
+}
+
+void UCP0CharacterMovement::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+{
+	FMovementTimers::FScope Timer{FMovementTimers::StateBeforeMovement};
+
+	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+
+	// 이동 시간 기준으로 흘러야 재생할 때도 같은 결과가 나온다
+	PostureSwitchTimeLeft = FMath::Max(PostureSwitchTimeLeft - DeltaSeconds, 0.0f);
+
+	if (!IsMovingOnGround())
+		WantedPosture = EPosture::Stand;
+
+	if (WantedPosture != Posture)
+	{
+		// 전환 중이라 미뤄진 게 아니라 막혀서 거부되었으면 요청을 지운다. 남겨두면 매 이동마다 다시 검사하다가
+		// 공간이 생기는 순간 입력 없이 자세가 바뀐다
+		const auto bOnGround = IsMovingOnGround();
+		const auto bDelayed = bOnGround && IsPostureSwitching();
+		if (!TrySetPosture(WantedPosture, bOnGround ? SPCL_CheckAll : SPCL_IgnoreDelay) && !bDelayed)
+			WantedPosture = Posture;
+	}
+
+	if (bWantsToSprint != bSprinting)
+		bWantsToSprint ? TryStartSprint() : StopSprint();
+
+	ProcessSprint();
+}
+
+void UCP0CharacterMovement::ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse)
+{
+	// 위치를 보정하기 전에 캡슐 크기부터 서버와 맞춘다
+	if (!MoveResponse.IsGoodMove())
+	{
+		const auto& Response = static_cast<const FCP0MoveResponseDataContainer&>(MoveResponse);
+		if (Posture != Response.Posture)
+			TrySetPosture(Response.Posture, SPCL_Correction);
+
+		PostureSwitchTimeLeft = Response.PostureSwitchTimeLeft;
+		bSprinting = Response.bSprinting;
+	}
+
+	Super::ClientHandleMoveResponse(MoveResponse);
+}
+
+bool UCP0CharacterMovement::ClientUpdatePositionAfterServerUpdate()
 {
-	return GetWorld()->GetTimeSeconds();
+	// 재생 중에 저장된 이동의 입력으로 덮어써지므로 현재 입력을 보존
+	const auto RealWantedPosture = WantedPosture;
+	const auto bRealWantsToSprint = bWantsToSprint;
+	const auto bRealWalkingSlow = bWalkingSlow;
+	const auto PostureBeforeReplay = Posture;
+
+	const auto bResult = Super::ClientUpdatePositionAfterServerUpdate();
+
+	WantedPosture = RealWantedPosture;
+	bWantsToSprint = bRealWantsToSprint;
+	bWalkingSlow = bRealWalkingSlow;
+
+	// 재생 중에는 시점을 건드리지 않으므로 재생 결과 자세가 달라졌을 때만 한 번 맞춘다
+	if (Posture != PostureBeforeReplay)
+	{
+		const auto Owner = GetCP0Owner();
+		Owner->SetEyeHeightWithBlend(Owner->GetDefaultEyeHeight(Posture), PostureSwitchTimeLeft);
+	}
+
+	return bResult;
 }
 
 const UCP0CharacterMovement* UCP0CharacterMovement::GetDefaultSelf() const
 {
-	return GetDefault<ACP0Character>(GetCP0Owner()->GetClass())->GetCP0Movement();
+	if (!DefaultSelf)
+		DefaultSelf = GetDefault<ACP0Character>(GetCP0Owner()->GetClass())->GetCP0Movement();
+
+	return DefaultSelf;
 }
 
-void UCP0CharacterMovement::ProcessSprint()
+const FPostureTable& UCP0CharacterMovement::GetPostureTable() const
+{
+	if (!PostureTable)
+	{
+		const auto Default = GetDefaultSelf();
+		const auto Data = Default->PostureData ? Default->PostureData : Default->FallbackPostureData;
+		check(Data);
+		PostureTable = &Data->GetTable();
+	}
+	return *PostureTable;
+}
+
+void UCP0CharacterMovement::BuildFallbackPostureData()
 {
-	if (!bSprinting)
+	// 템플릿이 생성되거나 로드될 때 미리 만들어서 플레이 중에 기본 객체를 고치지 않는다.
+	// 로드될 때는 같은 패키지의 캡슐도 이미 읽혀 있다
+	if (PostureData || !HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
 		return;
 
-	if (IsActuallySprinting())
-		LastActualSprintTime = GetWorld()->GetTimeSeconds();
+	const auto Owner = Cast<ACharacter>(GetOuter());
+	const auto Capsule = Owner ? Owner->GetCapsuleComponent() : nullptr;
 
-	switch (GetOwnerRole())
+	const auto Data = NewObject<UCP0PostureData>(this, NAME_None, RF_Transient);
+	Data->Stand.MaxSpeed = MaxWalkSpeed;
+	Data->Stand.MaxAcceleration = MaxAcceleration;
+	Data->Stand.HalfHeight = Capsule ? Capsule->GetScaledCapsuleHalfHeight() : Data->Stand.HalfHeight;
+	Data->Stand.RotationRate = RotationRate.Yaw;
+	Data->Crouch.MaxSpeed = MaxWalkSpeedCrouched;
+	Data->Crouch.HalfHeight = CrouchedHalfHeight;
+	Data->Compile();
+	FallbackPostureData = Data;
+}
+
+void UCP0CharacterMovement::ProcessSprint()
+{
+	// 조건이 깨지면 다시 입력할 때까지 달리지 않는다
+	if (bSprinting && !CanSprint())
 	{
-	case ROLE_Authority:
-	case ROLE_AutonomousProxy:
-		if (!CanSprint())
-			StopSprint();
-	default: ;
+		StopSprint();
+		bWantsToSprint = false;
 	}
 }
 
 void UCP0CharacterMovement::ProcessPronePush()
 {
-	if (Posture != EPosture::Prone)
-		return;
+	FMovementTimers::FScope Timer{FMovementTimers::PronePush};
 
-	const auto* const Owner = GetCP0Owner();
-	if (!Owner->IsLocallyControlled())
+	if (Posture != EPosture::Prone || !GetCP0Owner()->IsLocallyControlled())
+	{
+		ProneQuery.Push[0].Invalidate();
+		ProneQuery.Push[1].Invalidate();
 		return;
+	}
 
+	// 지난 프레임에 요청한 결과로 밀어내고, 다음 프레임에 쓸 것을 요청
+	const auto Location = UpdatedComponent->GetComponentLocation();
+	FVector Input{0.0f};
+	for (auto& Handle : ProneQuery.Push)
+	{
+		FHitResult Hit;
+		auto bBlocked = false;
+		if (ReadAsyncTrace(Handle, Hit, bBlocked) && bBlocked)
+			Input += (Location - Hit.ImpactPoint) * Hit.Distance;
+	}
+	ForceInput += Input.GetClampedToMaxSize(1.0f);
+
+	RequestPronePushTraces();
+}
+
+void UCP0CharacterMovement::RequestPronePushTraces()
+{
+	const auto* const Owner = GetCP0Owner();
 	const auto* const Capsule = Owner->GetCapsuleComponent();
-	const auto* const DefaultCapsule = GetDefault<ACP0Character>(Owner->GetClass())->GetCapsuleComponent();
 	const auto Radius = Capsule->GetScaledCapsuleRadius();
-	const auto HalfLength = DefaultCapsule->GetScaledCapsuleHalfHeight();
+	const auto HalfLength = GetDefaultHalfHeight(EPosture::Stand);
 	const auto Location = Capsule->GetComponentLocation();
 	const auto Forward = Capsule->GetForwardVector().RotateAngleAxis(MeshPitchOffset, Capsule->GetRightVector());
 	const auto Shape = FCollisionShape::MakeBox({0.0f, Radius, 0.0f});
 	constexpr auto OffsetX = -28.0f;
 
-	FVector Input{0.0f};
-	for (const auto Diff : {HalfLength, -HalfLength})
+	const auto Cache = GetWorld()->GetSubsystem<UTerrainCacheSubsystem>();
+
+	const float Diffs[]{HalfLength, -HalfLength};
+	for (auto i = 0; i < 2; ++i)
 	{
-		const auto Offset = Forward * (Diff + OffsetX);
-		FHitResult Hit;
-		if (GetWorld()->SweepSingleByChannel(Hit, Location, Location + Offset, Capsule->GetComponentQuat(),
-		                                     PushTraceChannel, Shape))
-		{
-			Input += (Location - Hit.ImpactPoint) * Hit.Distance;
-		}
+		const auto End = Location + Forward * (Diffs[i] + OffsetX);
+		const auto bClear = Cache && Cache->IsClear(Location, End, Radius, PushTraceChannel);
+		ProneQuery.Push[i] = GetWorld()->AsyncSweepByChannel(EAsyncTraceType::Single, Location, End,
+		                                                     Capsule->GetComponentQuat(), PushTraceChannel, Shape,
+		                                                     MakeProneQueryParams(bClear));
 	}
-	ForceInput += Input.GetClampedToMaxSize(1.0f);
 }
 
 void UCP0CharacterMovement::ProcessPronePitch(float DeltaTime)
 {
-	MeshPitchOffset = Posture == EPosture::Prone ? CalcFloorPitch() : 0.0f;
+	FMovementTimers::FScope Timer{FMovementTimers::PronePitch};
+
+	if (Posture != EPosture::Prone)
+	{
+		MeshPitchOffset = 0.0f;
+		ProneQuery.Floor[0].Invalidate();
+		ProneQuery.Floor[1].Invalidate();
+	}
+	else
+	{
+		// 결과가 아직 없으면 (엎드린 첫 프레임 등) 이전 값을 유지
+		FVector Floors[2];
+		bool bFloors[2];
+		auto bReady = true;
+		for (auto i = 0; i < 2; ++i)
+		{
+			FHitResult Hit;
+			auto bBlocked = false;
+			bReady &= ReadAsyncTrace(ProneQuery.Floor[i], Hit, bBlocked);
+			bFloors[i] = bBlocked || ProneQuery.bStaticFloor[i];
+			Floors[i] = bBlocked ? Hit.Location : ProneQuery.StaticFloor[i];
+		}
+
+		if (bReady)
+			MeshPitchOffset = bFloors[0] && bFloors[1] ? CalcFloorPitch(Floors[0], Floors[1]) : 0.0f;
+
+		// 비동기 트레이스 결과는 다음 프레임에만 읽을 수 있으므로, 간격을 두더라도 틱은 매 프레임 돌고 요청만 거른다
+		if (PawnOwner->IsLocallyControlled())
+		{
+			RequestFloorTraces();
+		}
+		else if (bCosmeticTraces)
+		{
+			TimeUntilCosmeticTrace -= DeltaTime;
+			if (TimeUntilCosmeticTrace <= 0.0f)
+			{
+				TimeUntilCosmeticTrace = CosmeticTraceInterval;
+				RequestFloorTraces();
+			}
+		}
+	}
+
 	if (PawnOwner->IsLocallyControlled())
 	{
 		const auto Threshold = GetWalkableFloorAngle();
@@ -495,19 +805,6 @@ void UCP0CharacterMovement::UpdateViewPitchLimit(float DeltaTime) const
 	PCM->ViewPitchMax = FMath::FInterpTo(PCM->ViewPitchMax, Limit.Y, DeltaTime, Speed);
 }
 
-void UCP0CharacterMovement::CorrectClientState()
-{
-	if (GetOwner()->GetRemoteRole() != ROLE_AutonomousProxy)
-		return;
-
-	const auto Now = GetWorld()->GetRealTimeSeconds();
-	if (NextCorrectionTime <= Now)
-	{
-		Client_CorrectState({Posture, PrevPosture, bSprinting});
-		NextCorrectionTime = Now + 0.5f;
-	}
-}
-
 void UCP0CharacterMovement::ShrinkPerchRadius()
 {
 	if (GetOwnerRole() == ROLE_SimulatedProxy)
@@ -524,18 +821,7 @@ void UCP0CharacterMovement::ProcessSlowWalk()
 
 void UCP0CharacterMovement::UpdateRotationRate()
 {
-	RotationRate.Yaw = [this]()
-	{
-		switch (Posture)
-		{
-		case EPosture::Crouch:
-			return 90.0f;
-		case EPosture::Prone:
-			return 45.0f;
-		default:
-			return GetDefaultSelf()->RotationRate.Yaw;
-		}
-	}();
+	RotationRate.Yaw = GetPostureTable().GetRotationRate(Posture);
 
 	constexpr auto MaxSpeed = 10.0f;
 	if (Velocity.SizeSquared() > MaxSpeed * MaxSpeed)
@@ -569,25 +855,6 @@ void UCP0CharacterMovement::ProcessForceTurn() const
 	}
 }
 
-void UCP0CharacterMovement::Client_CorrectState_Implementation(FCP0MovementCorrectionData Data)
-{
-	const auto PingMs = PawnOwner->GetPlayerState()->GetPing() * 4.0f;
-	const auto Now = GetWorld()->GetRealTimeSeconds();
-
-	auto IsExpired = [&](float LastModified) { return (Now - LastModified) * 1000.0f >= PingMs; };
-
-	if (Posture != Data.Posture && IsExpired(Posture_LastModifiedTime))
-	{
-		Posture = Data.PrevPosture;
-		TrySetPosture(Data.Posture, SPCL_Correction);
-	}
-
-	if (bSprinting != Data.bSprinting && IsExpired(Sprinting_LastModifiedTime))
-	{
-		bSprinting = Data.bSprinting;
-	}
-}
-
 void UCP0CharacterMovement::OnRep_Posture(EPosture Prev)
 {
 	const auto New = Posture;
@@ -599,65 +866,69 @@ void UCP0CharacterMovement::SetPosture(EPosture NewPosture)
 {
 	PrevPosture = Posture;
 	Posture = NewPosture;
-	Posture_LastModifiedTime = GetWorld()->GetRealTimeSeconds();
+
+	if (GetOwnerRole() == ROLE_Authority)
+		MARK_PROPERTY_DIRTY_FROM_NAME(UCP0CharacterMovement, Posture, this);
 }
 
 void UCP0CharacterMovement::SetSprinting(bool bNewValue)
 {
 	bSprinting = bNewValue;
-	Sprinting_LastModifiedTime = GetWorld()->GetRealTimeSeconds();
+
+	if (GetOwnerRole() == ROLE_Authority)
+		MARK_PROPERTY_DIRTY_FROM_NAME(UCP0CharacterMovement, bSprinting, this);
 }
 
 void FInputAction_Sprint::Enable(ACP0Character* Character)
 {
-	Character->GetCP0Movement()->TryStartSprint();
+	Character->GetCP0Movement()->RequestSprint(true);
 }
 
 void FInputAction_Sprint::Disable(ACP0Character* Character)
 {
-	Character->GetCP0Movement()->StopSprint();
+	Character->GetCP0Movement()->RequestSprint(false);
 }
 
 void FInputAction_Sprint::Toggle(ACP0Character* Character)
 {
 	const auto Movement = Character->GetCP0Movement();
-	Movement->IsInSprintMode() ? Movement->StopSprint() : Movement->TryStartSprint();
+	Movement->RequestSprint(!Movement->IsInSprintMode());
 }
 
 void FInputAction_Crouch::Enable(ACP0Character* Character)
 {
-	Character->GetCP0Movement()->TrySetPosture(EPosture::Crouch);
+	Character->GetCP0Movement()->RequestPosture(EPosture::Crouch);
 }
 
 void FInputAction_Crouch::Disable(ACP0Character* Character)
 {
 	const auto Movement = Character->GetCP0Movement();
-	if (Movement->GetPosture() == EPosture::Crouch)
-		Movement->TrySetPosture(EPosture::Stand);
+	if (Movement->GetWantedPosture() == EPosture::Crouch)
+		Movement->RequestPosture(EPosture::Stand);
 }
 
 void FInputAction_Crouch::Toggle(ACP0Character* Character)
 {
 	const auto Movement = Character->GetCP0Movement();
-	Movement->TrySetPosture(Movement->GetPosture() == EPosture::Crouch ? EPosture::Stand : EPosture::Crouch);
+	Movement->RequestPosture(Movement->GetWantedPosture() == EPosture::Crouch ? EPosture::Stand : EPosture::Crouch);
 }
 
 void FInputAction_Prone::Enable(ACP0Character* Character)
 {
-	Character->GetCP0Movement()->TrySetPosture(EPosture::Prone);
+	Character->GetCP0Movement()->RequestPosture(EPosture::Prone);
 }
 
 void FInputAction_Prone::Disable(ACP0Character* Character)
 {
 	const auto Movement = Character->GetCP0Movement();
-	if (Movement->GetPosture() == EPosture::Prone)
-		Movement->TrySetPosture(EPosture::Stand);
+	if (Movement->GetWantedPosture() == EPosture::Prone)
+		Movement->RequestPosture(EPosture::Stand);
 }
 
 void FInputAction_Prone::Toggle(ACP0Character* Character)
 {
 	const auto Movement = Character->GetCP0Movement();
-	Movement->TrySetPosture(Movement->GetPosture() == EPosture::Prone ? EPosture::Stand : EPosture::Prone);
+	Movement->RequestPosture(Movement->GetWantedPosture() == EPosture::Prone ? EPosture::Stand : EPosture::Prone);
 }
 
 void FInputAction_WalkSlow::Enable(ACP0Character* Character)
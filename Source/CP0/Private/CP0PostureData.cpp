@@ -0,0 +1,57 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#include "CP0PostureData.h"
+
+UCP0PostureData::UCP0PostureData()
+{
+	Crouch.MaxSpeed = 150.0f;
+	Crouch.MaxAcceleration = 512.0f;
+	Crouch.HalfHeight = 60.0f;
+
+	Prone.MaxSpeed = 100.0f;
+	Prone.MaxAcceleration = 256.0f;
+	Prone.HalfHeight = 34.0f;
+	Prone.RotationRate = 45.0f;
+}
+
+void UCP0PostureData::Compile()
+{
+	const FPostureTuning* const Tunings[FPostureTable::Num]{&Stand, &Crouch, &Prone};
+
+	for (auto i = 0; i < FPostureTable::Num; ++i)
+	{
+		Table.MaxSpeed[i] = Tunings[i]->MaxSpeed;
+		Table.MaxAcceleration[i] = Tunings[i]->MaxAcceleration;
+		Table.HalfHeight[i] = Tunings[i]->HalfHeight;
+		Table.RotationRate[i] = Tunings[i]->RotationRate;
+	}
+
+	const float SwitchTime[FPostureTable::Num][FPostureTable::Num]{
+		{0.0f, StandToCrouch, StandToProne},
+		{CrouchToStand, 0.0f, CrouchToProne},
+		{ProneToStand, ProneToCrouch, 0.0f},
+	};
+	FMemory::Memcpy(Table.SwitchTime, SwitchTime, sizeof SwitchTime);
+
+	Table.SprintSpeed = SprintSpeed;
+}
+
+void UCP0PostureData::PostInitProperties()
+{
+	Super::PostInitProperties();
+	Compile();
+}
+
+void UCP0PostureData::PostLoad()
+{
+	Super::PostLoad();
+	Compile();
+}
+
+#if WITH_EDITOR
+void UCP0PostureData::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	Compile();
+}
+#endif
@@ -0,0 +1,279 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#include "CP0ReplicationGraph.h"
+#include "CP0Character.h"
+#include "Weapon.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "UObject/UObjectIterator.h"
+
+void UCP0ReplicationGraph::OnWeaponOwnerChanged(AWeapon* Weapon, AActor* OldOwner)
+{
+	const auto Graph = Find(Weapon);
+	if (!Graph)
+		return;
+
+	if (OldOwner)
+	{
+		if (const auto OldInfo = Graph->GlobalActorReplicationInfoMap.Find(OldOwner))
+			OldInfo->DependentActorList.Remove(Weapon);
+	}
+
+	if (const auto NewOwner = Weapon->GetOwner())
+	{
+		auto& NewInfo = Graph->GlobalActorReplicationInfoMap.Get(NewOwner);
+		NewInfo.DependentActorList.PrepareForWrite();
+		NewInfo.DependentActorList.ConditionalAdd(Weapon);
+	}
+}
+
+void UCP0ReplicationGraph::SetNetUpdateFrequency(AActor* Actor, float Frequency)
+{
+	const auto Graph = Find(Actor);
+	if (!Graph)
+		return;
+
+	if (const auto Info = Graph->GlobalActorReplicationInfoMap.Find(Actor))
+		Info->Settings.ReplicationPeriodFrame = Graph->GetReplicationPeriod(Frequency);
+}
+
+void UCP0ReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// 명시한 규칙은 하위 클래스(블루프린트 포함)에 그대로 상속된다. 나머지는 GetMappingPolicy에서 CDO로 정한다
+	ClassRepNodePolicies.Set(AReplicationGraphDebugActor::StaticClass(), ECP0RepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(APlayerState::StaticClass(), ECP0RepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(APlayerController::StaticClass(), ECP0RepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(ACP0Character::StaticClass(), ECP0RepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(AWeapon::StaticClass(), ECP0RepNodeMapping::NotRouted);
+
+	// 나중에 로드되는 클래스가 기댈 기본값
+	const auto ActorCDO = GetDefault<AActor>();
+	FClassReplicationInfo DefaultInfo;
+	DefaultInfo.SetCullDistanceSquared(ActorCDO->NetCullDistanceSquared);
+	DefaultInfo.ReplicationPeriodFrame = GetReplicationPeriod(ActorCDO->NetUpdateFrequency);
+	GlobalActorReplicationInfoMap.SetClassInfo(AActor::StaticClass(), DefaultInfo);
+
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		const auto Class = *It;
+		if (!Class->IsChildOf(AActor::StaticClass()) || Class->HasAnyClassFlags(CLASS_NewerVersionExists))
+			continue;
+
+		const auto CDO = Class->GetDefaultObject<AActor>();
+		if (!CDO || !CDO->GetIsReplicated())
+			continue;
+
+		const auto Name = Class->GetName();
+		if (Name.StartsWith(TEXT("SKEL_")) || Name.StartsWith(TEXT("REINST_")))
+			continue;
+
+		const auto Policy = GetMappingPolicy(Class);
+
+		FClassReplicationInfo Info;
+		if (Policy >= ECP0RepNodeMapping::Spatialize_Static)
+			Info.SetCullDistanceSquared(CDO->NetCullDistanceSquared);
+		Info.ReplicationPeriodFrame = GetReplicationPeriod(CDO->NetUpdateFrequency);
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, Info);
+	}
+}
+
+void UCP0ReplicationGraph::InitGlobalGraphNodes()
+{
+	Super::InitGlobalGraphNodes();
+
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = CellSize;
+	GridNode->SpatialBias = {SpatialBias, SpatialBias};
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+
+	AddGlobalGraphNode(CreateNewNode<UCP0ReplicationGraphNode_PlayerStateFrequencyLimiter>());
+}
+
+void UCP0ReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	const auto Node = CreateNewNode<UCP0ReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	Node->OwnerOnlyActors = &OwnerOnlyActors;
+	AddConnectionGraphNode(Node, RepGraphConnection);
+}
+
+void UCP0ReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo,
+                                                       FGlobalActorReplicationInfo& GlobalInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case ECP0RepNodeMapping::NotRouted:
+		break;
+
+	case ECP0RepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+
+	case ECP0RepNodeMapping::RelevantOwnerConnection:
+		OwnerOnlyActors.AddUnique(ActorInfo.Actor);
+		break;
+
+	case ECP0RepNodeMapping::Spatialize_Static:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+
+	case ECP0RepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+
+	case ECP0RepNodeMapping::Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+	}
+
+	// 이미 소유자가 있는 채로 스폰된 무기
+	if (const auto Weapon = Cast<AWeapon>(ActorInfo.Actor))
+		OnWeaponOwnerChanged(Weapon, nullptr);
+}
+
+void UCP0ReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case ECP0RepNodeMapping::NotRouted:
+		break;
+
+	case ECP0RepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+
+	case ECP0RepNodeMapping::RelevantOwnerConnection:
+		OwnerOnlyActors.RemoveSingleSwap(ActorInfo.Actor, false);
+		break;
+
+	case ECP0RepNodeMapping::Spatialize_Static:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+
+	case ECP0RepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+
+	case ECP0RepNodeMapping::Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+	}
+
+	// 파괴되는 무기가 소유자의 종속 목록에 남지 않게 한다
+	const auto Weapon = Cast<AWeapon>(ActorInfo.Actor);
+	const auto Owner = Weapon ? Weapon->GetOwner() : nullptr;
+	if (const auto OwnerInfo = Owner ? GlobalActorReplicationInfoMap.Find(Owner) : nullptr)
+		OwnerInfo->DependentActorList.Remove(Weapon);
+}
+
+UCP0ReplicationGraph* UCP0ReplicationGraph::Find(const AActor* Actor)
+{
+	const auto Driver = Actor ? Actor->GetNetDriver() : nullptr;
+	return Driver ? Cast<UCP0ReplicationGraph>(Driver->GetReplicationDriver()) : nullptr;
+}
+
+ECP0RepNodeMapping UCP0ReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+	if (const auto Policy = ClassRepNodePolicies.Get(Class))
+		return *Policy;
+
+	// 규칙이 없는 클래스는 CDO 설정으로 정하고 기억해둔다. 무기가 아닌 bNetUseOwnerRelevancy 액터는 소유자에
+	// 붙어 다니는 것으로 보고 움직이는 액터로 그리드에 넣는다
+	const auto CDO = Class->GetDefaultObject<AActor>();
+	auto Policy = ECP0RepNodeMapping::Spatialize_Static;
+	if (CDO->bAlwaysRelevant)
+		Policy = ECP0RepNodeMapping::RelevantAllConnections;
+	else if (CDO->bOnlyRelevantToOwner)
+		Policy = ECP0RepNodeMapping::RelevantOwnerConnection;
+	else if (CDO->NetDormancy >= DORM_DormantAll)
+		Policy = ECP0RepNodeMapping::Spatialize_Dormancy;
+	else if (CDO->IsReplicatingMovement() || CDO->bNetUseOwnerRelevancy)
+		Policy = ECP0RepNodeMapping::Spatialize_Dynamic;
+
+	ClassRepNodePolicies.Set(Class, Policy);
+	return Policy;
+}
+
+uint32 UCP0ReplicationGraph::GetReplicationPeriod(float Frequency) const
+{
+	const auto TickRate = NetDriver ? NetDriver->NetServerMaxTickRate : 30;
+	return FMath::Max(FMath::RoundToInt(TickRate / FMath::Max(Frequency, 1.0f)), 1);
+}
+
+void UCP0ReplicationGraphNode_AlwaysRelevant_ForConnection::GatherActorListsForConnection(
+	const FConnectionGatherActorListParameters& Params)
+{
+	ReplicationActorList.Reset();
+
+	for (const auto& Viewer : Params.Viewers)
+	{
+		ReplicationActorList.ConditionalAdd(Viewer.InViewer);
+		ReplicationActorList.ConditionalAdd(Viewer.ViewTarget);
+
+		const auto PC = Cast<APlayerController>(Viewer.InViewer);
+		if (!PC)
+			continue;
+
+		// 자기 폰과 플레이어 스테이트는 묶음을 기다리지 않는다. 무기는 폰의 종속 액터로 따라온다
+		const auto Pawn = PC->GetPawn();
+		if (Pawn && Pawn != Viewer.ViewTarget)
+			ReplicationActorList.ConditionalAdd(Pawn);
+
+		ReplicationActorList.ConditionalAdd(PC->PlayerState);
+	}
+
+	if (OwnerOnlyActors)
+	{
+		const auto Connection = Params.ConnectionManager.NetConnection;
+		for (const auto Actor : *OwnerOnlyActors)
+		{
+			if (Actor->GetNetConnection() == Connection)
+				ReplicationActorList.ConditionalAdd(Actor);
+		}
+	}
+
+	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
+}
+
+UCP0ReplicationGraphNode_PlayerStateFrequencyLimiter::UCP0ReplicationGraphNode_PlayerStateFrequencyLimiter()
+{
+	bRequiresPrepareForReplicationCall = true;
+}
+
+void UCP0ReplicationGraphNode_PlayerStateFrequencyLimiter::PrepareForReplication()
+{
+	ReplicationActorLists.Reset();
+
+	const auto GameState = GetWorld()->GetGameState();
+	if (!GameState)
+		return;
+
+	for (const auto PlayerState : GameState->PlayerArray)
+	{
+		if (!IsActorValidForReplicationGather(PlayerState))
+			continue;
+
+		if (ReplicationActorLists.Num() == 0 || ReplicationActorLists.Last().Num() >= ActorsPerFrame)
+			ReplicationActorLists.AddDefaulted_GetRef().PrepareForWrite();
+
+		ReplicationActorLists.Last().Add(PlayerState);
+	}
+}
+
+void UCP0ReplicationGraphNode_PlayerStateFrequencyLimiter::GatherActorListsForConnection(
+	const FConnectionGatherActorListParameters& Params)
+{
+	if (ReplicationActorLists.Num() == 0)
+		return;
+
+	const auto Idx = (Params.ReplicationFrameNum + Params.ConnectionManager.ConnectionId) % ReplicationActorLists.Num();
+	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorLists[Idx]);
+}
@@ -0,0 +1,168 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#include "CharacterUpdate.h"
+#include "CP0Character.h"
+#include "Weapon.h"
+#include "WeaponComponent.h"
+#include "Camera/CameraComponent.h"
+
+void UCharacterUpdateSubsystem::Register(ACP0Character* Character)
+{
+	if (States.IsValidIndex(Character->UpdateIndex))
+		return;
+
+	const auto Default = GetDefault<ACP0Character>(Character->GetClass());
+
+	// 데디케이티드 서버에서는 눈높이(사격 위치)만 갱신한다
+	const auto bCosmetic = !Character->IsNetMode(NM_DedicatedServer);
+
+	FState State;
+	State.bArms = bCosmetic && Character->ArmsMesh;
+	State.bCamera = bCosmetic && Character->Camera;
+	if (State.bArms)
+		State.ArmsBase = Default->ArmsMesh->GetRelativeTransform();
+	if (Default->LegsMesh)
+		State.LegsOffset = Default->LegsMesh->GetRelativeLocation().Y;
+	State.TargetEyeHeight = State.PrevEyeHeight = Character->GetEyeHeight();
+
+	Character->UpdateIndex = States.Add(State);
+	Characters.Add(Character);
+}
+
+void UCharacterUpdateSubsystem::Unregister(ACP0Character* Character)
+{
+	const auto Idx = Character->UpdateIndex;
+	if (!States.IsValidIndex(Idx))
+		return;
+
+	Character->UpdateIndex = INDEX_NONE;
+	States.RemoveAtSwap(Idx, 1, false);
+	Characters.RemoveAtSwap(Idx, 1, false);
+
+	if (Characters.IsValidIndex(Idx) && Characters[Idx].IsValid())
+		Characters[Idx]->UpdateIndex = Idx;
+}
+
+bool UCharacterUpdateSubsystem::BlendEyeHeight(const ACP0Character* Character, float NewEyeHeight, float BlendTime)
+{
+	if (!States.IsValidIndex(Character->UpdateIndex))
+		return false;
+
+	auto& State = States[Character->UpdateIndex];
+	State.TargetEyeHeight = NewEyeHeight;
+	State.EyeHeightBlendTime = BlendTime;
+	State.PrevEyeHeight = Character->GetEyeHeight();
+	State.EyeHeightAlpha = BlendTime > KINDA_SMALL_NUMBER ? 0.0f : 1.0f;
+	return State.EyeHeightAlpha < 1.0f;
+}
+
+void UCharacterUpdateSubsystem::SetUpdateRate(const ACP0Character* Character, float Interval, bool bArms)
+{
+	if (!States.IsValidIndex(Character->UpdateIndex))
+		return;
+
+	auto& State = States[Character->UpdateIndex];
+	State.Interval = Interval;
+	State.TimeUntilUpdate = FMath::Min(State.TimeUntilUpdate, Interval);
+	State.bArms = bArms && Character->ArmsMesh;
+}
+
+void UCharacterUpdateSubsystem::SetLegsEnabled(const ACP0Character* Character, bool bLegs)
+{
+	if (States.IsValidIndex(Character->UpdateIndex))
+		States[Character->UpdateIndex].bLegs = bLegs && Character->LegsMesh;
+}
+
+void UCharacterUpdateSubsystem::Tick(float DeltaTime)
+{
+	// 계산: 캐릭터에서는 필요한 값만 읽고, 상태는 배열 안에서 갱신한다
+	Writes.Reset();
+	for (auto i = 0; i < States.Num(); ++i)
+	{
+		auto& State = States[i];
+		State.PendingDelta += DeltaTime;
+		State.TimeUntilUpdate -= DeltaTime;
+		if (State.TimeUntilUpdate > 0.0f)
+			continue;
+
+		const auto Character = Characters[i].Get();
+		if (!Character)
+			continue;
+
+		State.TimeUntilUpdate = FMath::Max(State.TimeUntilUpdate + State.Interval, 0.0f);
+		Update(State, Character, State.PendingDelta, Writes.AddUninitialized_GetRef());
+		State.PendingDelta = 0.0f;
+	}
+
+	// 쓰기: 컴포넌트 트랜스폼은 마지막에 한꺼번에
+	for (const auto& Write : Writes)
+		Apply(Write);
+}
+
+TStatId UCharacterUpdateSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCharacterUpdateSubsystem, STATGROUP_Tickables);
+}
+
+ETickableTickType UCharacterUpdateSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+void UCharacterUpdateSubsystem::Update(FState& State, ACP0Character* Character, float DeltaTime, FWrite& Write)
+{
+	if (State.EyeHeightAlpha < 1.0f)
+	{
+		State.EyeHeightAlpha = FMath::Clamp(State.EyeHeightAlpha + DeltaTime / State.EyeHeightBlendTime, 0.0f, 1.0f);
+		Character->SetEyeHeight(FMath::CubicInterp(State.PrevEyeHeight, 0.0f, State.TargetEyeHeight, 0.0f,
+		                                           State.EyeHeightAlpha));
+	}
+
+	const auto AimRot = Character->GetBaseAimRotation().GetNormalized();
+
+	Write.Character = Character;
+	Write.ViewLocation = Character->GetPawnViewLocation();
+	Write.bLegs = State.bLegs;
+	Write.bArms = State.bArms;
+	Write.bCamera = State.bCamera;
+
+	if (State.bLegs)
+	{
+		const FRotator ViewYaw{0.0f, AimRot.Yaw, 0.0f};
+		Write.Legs = Character->GetMesh()->GetComponentLocation() + ViewYaw.Vector() * State.LegsOffset;
+	}
+
+	if (State.bArms)
+	{
+		auto Diff = (State.PrevAimRot - AimRot).GetNormalized();
+		Diff.Yaw *= 1.0f - FMath::Abs(AimRot.Pitch) / 90.0f;
+
+		State.AimRotSpeed = FMath::RInterpTo(State.AimRotSpeed, Diff, DeltaTime, 10.0f);
+		State.ArmsLocalRotation = FMath::QInterpTo(State.ArmsLocalRotation, State.AimRotSpeed.Quaternion().Inverse(),
+		                                           DeltaTime, 10.0f);
+
+		Write.Arms = State.ArmsBase;
+		if (const auto Weapon = Character->WeaponComp->GetWeapon())
+			Write.Arms *= Weapon->ArmsOffset;
+		Write.Arms *= FTransform{State.ArmsLocalRotation};
+		Write.Arms *= {AimRot, Write.ViewLocation};
+	}
+
+	// 팔을 갱신하지 않는 동안에도 다시 켜질 때 튀지 않도록 이전 조준은 계속 따라간다
+	State.PrevAimRot = AimRot;
+}
+
+void UCharacterUpdateSubsystem::Apply(const FWrite& Write)
+{
+	const auto Character = Write.Character;
+
+	if (Write.bLegs)
+		Character->LegsMesh->SetWorldLocation(Write.Legs);
+
+	if (Write.bArms)
+		Character->ArmsMesh->SetWorldTransform(Write.Arms);
+
+	// 카메라 회전은 팔의 카메라 소켓을 따르므로 팔을 옮긴 뒤에 구한다
+	if (Write.bCamera)
+		Character->Camera->SetWorldLocationAndRotation(Write.ViewLocation, Character->GetViewRotation());
+}
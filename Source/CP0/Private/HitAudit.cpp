@@ -0,0 +1,235 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#include "HitAudit.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY(LogHitAudit);
+
+namespace
+{
+	// 2의 거듭제곱. 쓰기 스레드가 100ms마다 비우므로 이만큼이면 연사 중에도 넘치지 않는다
+	constexpr uint32 RingSize = 2048;
+	static_assert((RingSize & (RingSize - 1)) == 0, "Head and Tail wrap around uint32");
+
+	/**
+	 * 스레드별 단일 생산자/단일 소비자 링. 기록하는 스레드만 Head를, 쓰기 스레드만 Tail을 옮기므로 락이 필요 없다.
+	 * 링은 해제하지 않는다. 기록하는 스레드 수만큼만 생긴다.
+	 */
+	struct FThreadRing
+	{
+		FHitAuditRecord Records[RingSize];
+		TAtomic<uint32> Head{0};
+		TAtomic<uint32> Tail{0};
+		FThreadRing* Next = nullptr;
+	};
+
+	// 링 목록. 앞에 붙이기만 하므로 CAS 하나로 충분하다
+	TAtomic<FThreadRing*> Rings{nullptr};
+	thread_local FThreadRing* CurRing = nullptr;
+
+	FThreadRing& GetRing()
+	{
+		if (!CurRing)
+		{
+			CurRing = new FThreadRing;
+			auto First = Rings.Load();
+			do
+			{
+				CurRing->Next = First;
+			}
+			while (!Rings.CompareExchange(First, CurRing));
+		}
+		return *CurRing;
+	}
+
+	class FWriter final : public FRunnable
+	{
+	public:
+		explicit FWriter(IFileHandle* InFile)
+			: File{InFile}, WakeUp{FPlatformProcess::GetSynchEventFromPool()}
+		{
+		}
+
+		~FWriter()
+		{
+			FPlatformProcess::ReturnSynchEventToPool(WakeUp);
+		}
+
+		void Wake() const
+		{
+			WakeUp->Trigger();
+		}
+
+		// 기록이 드문드문 있어도 깨어날 때마다 모든 링을 비워서 서버가 죽더라도 최대한 남도록
+		uint32 Run() override
+		{
+			while (!bStopping)
+			{
+				WakeUp->Wait(100);
+				Drain();
+			}
+			Drain();
+			return 0;
+		}
+
+		void Stop() override
+		{
+			bStopping = true;
+			WakeUp->Trigger();
+		}
+
+	private:
+		void Drain()
+		{
+			auto bWritten = false;
+			for (auto Ring = Rings.Load(); Ring; Ring = Ring->Next)
+			{
+				const auto Tail = Ring->Tail.Load(EMemoryOrder::Relaxed);
+				const auto Head = Ring->Head.Load();
+				if (Head == Tail)
+					continue;
+
+				// 링 끝에서 잘리면 두 번에 나눠 쓴다
+				const auto Num = Head - Tail;
+				const auto Begin = Tail % RingSize;
+				const auto First = FMath::Min(Num, RingSize - Begin);
+				File->Write(reinterpret_cast<const uint8*>(&Ring->Records[Begin]), First * sizeof(FHitAuditRecord));
+				if (Num > First)
+					File->Write(reinterpret_cast<const uint8*>(Ring->Records), (Num - First) * sizeof(FHitAuditRecord));
+
+				Ring->Tail = Head;
+				bWritten = true;
+			}
+
+			if (bWritten)
+				File->Flush();
+		}
+
+		TUniquePtr<IFileHandle> File;
+		FEvent* WakeUp;
+		FThreadSafeBool bStopping;
+	};
+
+	FWriter* Writer = nullptr;
+	FRunnableThread* WriterThread = nullptr;
+
+	// Record 안에 있는 스레드 수. Stop은 이것이 0이 된 뒤에 쓰기 스레드를 정리한다
+	TAtomic<int32> NumRecording{0};
+
+	// 링이 가득 차서 버린 기록 수
+	TAtomic<uint32> NumDropped{0};
+
+	int32 GHitAudit = 0;
+	FAutoConsoleVariableRef CVarHitAudit{
+		TEXT("CP0.HitAudit"), GHitAudit,
+		TEXT("1: Record every shot, hit and weapon correction to Saved/HitAudit. 0: Stop recording."),
+		FConsoleVariableDelegate::CreateLambda([](IConsoleVariable* Var)
+		{
+			if (Var->GetInt() != 0)
+				FHitAudit::Start();
+			else
+				FHitAudit::Stop();
+		})
+	};
+}
+
+TAtomic<bool> FHitAudit::bEnabled{false};
+
+void FHitAudit::Record(const FHitAuditRecord& Rec)
+{
+	// bEnabled보다 먼저 세어야 Stop이 기다려야 할 스레드를 놓치지 않는다
+	++NumRecording;
+
+	if (bEnabled)
+	{
+		auto& Ring = GetRing();
+		const auto Head = Ring.Head.Load(EMemoryOrder::Relaxed);
+		const auto Num = Head - Ring.Tail.Load();
+		if (Num < RingSize)
+		{
+			Ring.Records[Head % RingSize] = Rec;
+			Ring.Head = Head + 1;
+
+			// 다음 주기까지 기다리지 않고 미리 비우게 한다
+			if (Num + 1 == RingSize / 2)
+				Writer->Wake();
+		}
+		else
+		{
+			++NumDropped;
+		}
+	}
+
+	--NumRecording;
+}
+
+void FHitAudit::Start()
+{
+	if (Writer)
+		return;
+
+	static auto bRegisteredExit = false;
+	if (!bRegisteredExit)
+	{
+		FCoreDelegates::OnExit.AddStatic(&FHitAudit::Stop);
+		bRegisteredExit = true;
+	}
+
+	auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const auto Dir = FPaths::ProjectSavedDir() / TEXT("HitAudit");
+	PlatformFile.CreateDirectoryTree(*Dir);
+
+	const auto Filename = Dir / FString::Printf(TEXT("HitAudit-%s.bin"), *FDateTime::Now().ToString());
+	const auto File = PlatformFile.OpenWrite(*Filename);
+	if (!File)
+	{
+		UE_LOG(LogHitAudit, Warning, TEXT("Failed to open %s"), *Filename);
+		return;
+	}
+
+	FHitAuditHeader Header;
+	Header.RecordSize = sizeof(FHitAuditRecord);
+	File->Write(reinterpret_cast<const uint8*>(&Header), sizeof Header);
+
+	Writer = new FWriter{File};
+	WriterThread = FRunnableThread::Create(Writer, TEXT("HitAuditWriter"), 0, TPri_BelowNormal);
+	bEnabled = true;
+
+	UE_LOG(LogHitAudit, Log, TEXT("Recording to %s"), *Filename);
+}
+
+void FHitAudit::Stop()
+{
+	if (!Writer)
+		return;
+
+	// 새 기록을 막고 이미 Record에 들어온 스레드가 나가기를 기다린다. 남은 기록은 쓰기 스레드가 끝나기 전에 모두 쓴다
+	bEnabled = false;
+	while (NumRecording.Load() > 0)
+		FPlatformProcess::Sleep(0.0f);
+
+	WriterThread->Kill(true);
+	delete WriterThread;
+	delete Writer;
+	WriterThread = nullptr;
+	Writer = nullptr;
+
+	if (const auto Dropped = NumDropped.Exchange(0))
+		UE_LOG(LogHitAudit, Warning, TEXT("Dropped %u records because a thread's buffer was full"), Dropped);
+}
+
+void FHitAudit::Flush()
+{
+	++NumRecording;
+
+	if (bEnabled)
+		Writer->Wake();
+
+	--NumRecording;
+}
@@ -0,0 +1,152 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#include "HitAuditCommandlet.h"
+#include "HitAudit.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	struct FShooterStats
+	{
+		int32 Bursts = 0;
+		int32 Shots = 0;
+		int32 Hits = 0;
+		int32 Corrections = 0;
+	};
+
+	const TCHAR* GetEventName(EHitAuditEvent Event)
+	{
+		switch (Event)
+		{
+		case EHitAuditEvent::BeginFiring:
+			return TEXT("BeginFiring");
+		case EHitAuditEvent::Shot:
+			return TEXT("Shot");
+		case EHitAuditEvent::Hit:
+			return TEXT("Hit");
+		case EHitAuditEvent::Correction:
+			return TEXT("Correction");
+		default:
+			return TEXT("?");
+		}
+	}
+}
+
+UHitAuditCommandlet::UHitAuditCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UHitAuditCommandlet::Main(const FString& Params)
+{
+	FString Filename;
+	if (!FParse::Value(*Params, TEXT("File="), Filename))
+	{
+		const auto Dir = FPaths::ProjectSavedDir() / TEXT("HitAudit");
+		TArray<FString> Files;
+		IFileManager::Get().FindFiles(Files, *(Dir / TEXT("*.bin")), true, false);
+		if (Files.Num() == 0)
+		{
+			UE_LOG(LogHitAudit, Error, TEXT("No audit files in %s"), *Dir);
+			return 1;
+		}
+
+		// 파일 이름에 시각이 들어가므로 사전순 정렬의 마지막이 가장 최근
+		Files.Sort();
+		Filename = Dir / Files.Last();
+	}
+
+	auto ShooterFilter = INDEX_NONE;
+	const auto bDump = FParse::Value(*Params, TEXT("Shooter="), ShooterFilter);
+
+	// 가능하면 메모리 맵으로 읽고, 지원하지 않는 플랫폼에서는 통째로 읽는다
+	TUniquePtr<IMappedFileHandle> MappedFile{FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename)};
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint8> Loaded;
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+
+	if (MappedFile)
+		MappedRegion.Reset(MappedFile->MapRegion());
+
+	if (MappedRegion)
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else if (FFileHelper::LoadFileToArray(Loaded, *Filename))
+	{
+		Data = Loaded.GetData();
+		Size = Loaded.Num();
+	}
+
+	if (!Data || Size < static_cast<int64>(sizeof(FHitAuditHeader)))
+	{
+		UE_LOG(LogHitAudit, Error, TEXT("Failed to read %s"), *Filename);
+		return 1;
+	}
+
+	FHitAuditHeader Header;
+	FMemory::Memcpy(&Header, Data, sizeof Header);
+	if (Header.Magic != FHitAuditHeader::MagicValue || Header.Version != FHitAuditHeader::CurrentVersion ||
+		Header.RecordSize != sizeof(FHitAuditRecord))
+	{
+		UE_LOG(LogHitAudit, Error, TEXT("%s is not a compatible audit file"), *Filename);
+		return 1;
+	}
+
+	const auto NumRecords = static_cast<int64>((Size - sizeof Header) / sizeof(FHitAuditRecord));
+	const auto Records = Data + sizeof Header;
+
+	TMap<int32, FShooterStats> Stats;
+	for (int64 i = 0; i < NumRecords; ++i)
+	{
+		FHitAuditRecord Rec;
+		FMemory::Memcpy(&Rec, Records + i * sizeof(FHitAuditRecord), sizeof Rec);
+
+		auto& Shooter = Stats.FindOrAdd(Rec.ShooterId);
+		switch (Rec.Event)
+		{
+		case EHitAuditEvent::BeginFiring:
+			++Shooter.Bursts;
+			break;
+		case EHitAuditEvent::Shot:
+			++Shooter.Shots;
+			break;
+		case EHitAuditEvent::Hit:
+			++Shooter.Hits;
+			break;
+		case EHitAuditEvent::Correction:
+			++Shooter.Corrections;
+			break;
+		}
+
+		if (bDump && Rec.ShooterId == ShooterFilter)
+		{
+			UE_LOG(LogHitAudit, Display,
+			       TEXT("%10.3f %-11s seed %5u shot %3u clip %3u state %u from %s target %d at %s"),
+			       Rec.Time, GetEventName(Rec.Event), Rec.Seed, Rec.ShotIndex, Rec.Clip, Rec.State,
+			       *Rec.ShooterPos.ToCompactString(), Rec.TargetId, *Rec.TargetPos.ToCompactString());
+		}
+	}
+
+	Stats.KeySort(TLess<int32>{});
+
+	UE_LOG(LogHitAudit, Display, TEXT("%s: %lld records"), *Filename, NumRecords);
+	for (const auto& Pair : Stats)
+	{
+		const auto& Shooter = Pair.Value;
+		const auto HitRate = Shooter.Shots > 0 ? 100.0f * Shooter.Hits / Shooter.Shots : 0.0f;
+		UE_LOG(LogHitAudit, Display, TEXT("Player %d: %d bursts, %d shots, %d hits (%.1f%%), %d corrections"),
+		       Pair.Key, Shooter.Bursts, Shooter.Shots, Shooter.Hits, HitRate, Shooter.Corrections);
+	}
+
+	return 0;
+}
@@ -0,0 +1,79 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#include "InputCapture.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogInputCapture, Log, All);
+
+namespace
+{
+	int32 GCaptureInput = 0;
+	FAutoConsoleVariableRef CVarCaptureInput{
+		TEXT("CP0.CaptureInput"), GCaptureInput,
+		TEXT("1: Record local character input. 0: Stop and save it to Saved/InputCapture.")
+	};
+}
+
+bool FInputCapture::IsEnabled()
+{
+	return GCaptureInput != 0;
+}
+
+FString FInputCapture::MakeFilename()
+{
+	const auto Dir = FPaths::ProjectSavedDir() / TEXT("InputCapture");
+	return Dir / FString::Printf(TEXT("Input-%s.bin"), *FDateTime::Now().ToString());
+}
+
+bool FInputCapture::Save(const FString& Filename) const
+{
+	auto SavedHeader = Header;
+	SavedHeader.FrameSize = sizeof(FInputCaptureFrame);
+	SavedHeader.NumFrames = Frames.Num();
+
+	const auto FramesSize = Frames.Num() * sizeof(FInputCaptureFrame);
+	TArray<uint8> Data;
+	Data.SetNumUninitialized(sizeof SavedHeader + FramesSize);
+	FMemory::Memcpy(Data.GetData(), &SavedHeader, sizeof SavedHeader);
+	FMemory::Memcpy(Data.GetData() + sizeof SavedHeader, Frames.GetData(), FramesSize);
+
+	if (!FFileHelper::SaveArrayToFile(Data, *Filename))
+	{
+		UE_LOG(LogInputCapture, Warning, TEXT("Failed to save %s"), *Filename);
+		return false;
+	}
+
+	UE_LOG(LogInputCapture, Log, TEXT("Saved %d frames to %s"), Frames.Num(), *Filename);
+	return true;
+}
+
+bool FInputCapture::Load(const FString& Filename)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *Filename))
+	{
+		UE_LOG(LogInputCapture, Error, TEXT("Failed to read %s"), *Filename);
+		return false;
+	}
+
+	if (Data.Num() < sizeof Header)
+	{
+		UE_LOG(LogInputCapture, Error, TEXT("%s is too small"), *Filename);
+		return false;
+	}
+
+	FMemory::Memcpy(&Header, Data.GetData(), sizeof Header);
+	if (Header.Magic != FInputCaptureHeader::MagicValue || Header.Version != FInputCaptureHeader::CurrentVersion
+		|| Header.FrameSize != sizeof(FInputCaptureFrame))
+	{
+		UE_LOG(LogInputCapture, Error, TEXT("%s is not a compatible input capture"), *Filename);
+		return false;
+	}
+
+	const auto NumFrames = FMath::Min<int64>(Header.NumFrames, (Data.Num() - sizeof Header) / Header.FrameSize);
+	Frames.SetNumUninitialized(NumFrames);
+	FMemory::Memcpy(Frames.GetData(), Data.GetData() + sizeof Header, NumFrames * sizeof(FInputCaptureFrame));
+	return true;
+}
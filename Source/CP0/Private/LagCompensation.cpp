@@ -0,0 +1,237 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#include "LagCompensation.h"
+#include "CP0Character.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+
+void ULagCompensationSubsystem::Register(ACP0Character* Character)
+{
+	for (const auto& History : Histories)
+		if (History.Character == Character)
+			return;
+
+	auto& History = Histories.AddDefaulted_GetRef();
+	History.Character = Character;
+
+	const auto Mesh = Character->GetMesh();
+	for (const auto& Hitbox : Character->GetHitboxes())
+	{
+		if (History.NumHitboxes >= MaxHitboxes)
+			break;
+
+		const auto BoneIdx = Mesh->GetBoneIndex(Hitbox.Bone);
+		if (BoneIdx == INDEX_NONE)
+			continue;
+
+		const auto Idx = History.NumHitboxes++;
+		History.BoneIndices[Idx] = BoneIdx;
+		History.Bones[Idx] = Hitbox.Bone;
+		History.HalfLengths[Idx] = Hitbox.HalfLength;
+		History.Radii[Idx] = Hitbox.Radius;
+	}
+
+	// 히트박스가 하나도 없으면 캡슐을 그대로 사용
+	if (History.NumHitboxes == 0)
+	{
+		History.NumHitboxes = 1;
+		History.BoneIndices[0] = INDEX_NONE;
+		History.Bones[0] = NAME_None;
+		History.HalfLengths[0] = 0.0f;
+		History.Radii[0] = Character->GetCapsuleComponent()->GetScaledCapsuleRadius();
+	}
+
+	History.MaxRadius = 0.0f;
+	for (auto i = 0; i < History.NumHitboxes; ++i)
+		History.MaxRadius = FMath::Max(History.MaxRadius, History.Radii[i]);
+}
+
+void ULagCompensationSubsystem::Unregister(ACP0Character* Character)
+{
+	for (auto i = Histories.Num() - 1; i >= 0; --i)
+	{
+		const auto Char = Histories[i].Character;
+		if (Char == Character || !Char.IsValid())
+			Histories.RemoveAtSwap(i, 1, false);
+	}
+}
+
+bool ULagCompensationSubsystem::Trace(const FVector& Start, const FVector& End, float Time, const AActor* Ignore,
+                                      FHitResult& OutHit) const
+{
+	const auto Delta = End - Start;
+	const auto Length = Delta.Size();
+	if (Length < KINDA_SMALL_NUMBER)
+		return false;
+
+	const auto Dir = Delta / Length;
+	const auto Now = GetWorld()->GetTimeSeconds();
+	Time = FMath::Clamp(Time, Now - MaxRewindTime, Now);
+
+	auto BestDist = Length;
+	const FHistory* Best = nullptr;
+	auto BestHitbox = 0;
+	FVector BestNormal;
+
+	for (const auto& History : Histories)
+	{
+		const auto Char = History.Character.Get();
+		if (!Char || Char == Ignore)
+			continue;
+
+		float Dist;
+		int32 Hitbox;
+		FVector Normal;
+		if (TraceHistory(History, Start, Dir, BestDist, Time, Dist, Hitbox, Normal))
+		{
+			BestDist = Dist;
+			Best = &History;
+			BestHitbox = Hitbox;
+			BestNormal = Normal;
+		}
+	}
+
+	if (!Best)
+		return false;
+
+	const auto Char = Best->Character.Get();
+	OutHit = FHitResult{Char, Char->GetMesh(), Start + Dir * BestDist, BestNormal};
+	OutHit.BoneName = Best->Bones[BestHitbox];
+	OutHit.Distance = BestDist;
+	OutHit.Time = BestDist / Length;
+	OutHit.TraceStart = Start;
+	OutHit.TraceEnd = End;
+	return true;
+}
+
+float ULagCompensationSubsystem::GetClientViewTime(const APawn* Viewer)
+{
+	const auto World = Viewer->GetWorld();
+	const auto GameState = World->GetGameState();
+	if (!GameState)
+		return World->GetTimeSeconds();
+
+	// 다른 캐릭터들은 대략 편도 지연시간만큼 과거의 모습으로 보인다
+	const auto PS = Viewer->GetPlayerState();
+	const auto PingMs = PS ? PS->GetPing() * 4.0f : 0.0f;
+	return GameState->GetServerWorldTimeSeconds() - PingMs / 2000.0f;
+}
+
+void ULagCompensationSubsystem::Tick(float DeltaTime)
+{
+	const auto Now = GetWorld()->GetTimeSeconds();
+	if (Now - LastRecordTime < MinRecordInterval)
+		return;
+
+	LastRecordTime = Now;
+	for (auto& History : Histories)
+	{
+		if (History.Character.IsValid())
+			Record(History, Now);
+	}
+}
+
+TStatId ULagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+ETickableTickType ULagCompensationSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+void ULagCompensationSubsystem::Record(FHistory& History, float Now)
+{
+	const auto Char = History.Character.Get();
+	const auto Mesh = Char->GetMesh();
+	const auto Capsule = Char->GetCapsuleComponent();
+
+	auto& Frame = History.Frames[History.Head];
+	Frame.Time = Now;
+	Frame.BoundCenter = Capsule->GetComponentLocation();
+
+	auto MaxDistSq = 0.0f;
+	for (auto i = 0; i < History.NumHitboxes; ++i)
+	{
+		FVector Center, Axis;
+		if (History.BoneIndices[i] != INDEX_NONE)
+		{
+			const auto BoneTF = Mesh->GetBoneTransform(History.BoneIndices[i]);
+			Center = BoneTF.GetLocation();
+			Axis = BoneTF.GetUnitAxis(EAxis::X) * History.HalfLengths[i];
+		}
+		else
+		{
+			const auto HalfHeight = Capsule->GetScaledCapsuleHalfHeight() - History.Radii[i];
+			Center = Frame.BoundCenter;
+			Axis = Capsule->GetUpVector() * FMath::Max(HalfHeight, 0.0f);
+		}
+
+		Frame.Start[i] = Center - Axis;
+		Frame.End[i] = Center + Axis;
+		MaxDistSq = FMath::Max(MaxDistSq, FVector::DistSquared(Frame.Start[i], Frame.BoundCenter));
+		MaxDistSq = FMath::Max(MaxDistSq, FVector::DistSquared(Frame.End[i], Frame.BoundCenter));
+	}
+	Frame.BoundRadius = FMath::Sqrt(MaxDistSq) + History.MaxRadius;
+
+	History.Head = (History.Head + 1) % HistorySize;
+	History.NumFrames = FMath::Min(History.NumFrames + 1, HistorySize);
+}
+
+bool ULagCompensationSubsystem::TraceHistory(const FHistory& History, const FVector& Start, const FVector& Dir,
+                                             float Length, float Time, float& OutDist, int32& OutHitbox,
+                                             FVector& OutNormal)
+{
+	if (History.NumFrames == 0)
+		return false;
+
+	auto Newer = (History.Head + HistorySize - 1) % HistorySize;
+	auto Older = Newer;
+	for (auto i = 1; i < History.NumFrames && History.Frames[Older].Time > Time; ++i)
+	{
+		Newer = Older;
+		Older = (Older + HistorySize - 1) % HistorySize;
+	}
+
+	const auto& A = History.Frames[Older];
+	const auto& B = History.Frames[Newer];
+	const auto Span = B.Time - A.Time;
+	const auto Alpha = Span > KINDA_SMALL_NUMBER ? FMath::Clamp((Time - A.Time) / Span, 0.0f, 1.0f) : 1.0f;
+
+	const auto BoundCenter = FMath::Lerp(A.BoundCenter, B.BoundCenter, Alpha);
+	const auto BoundRadius = FMath::Max(A.BoundRadius, B.BoundRadius);
+	const auto Closest = Start + Dir * FMath::Clamp((BoundCenter - Start) | Dir, 0.0f, Length);
+	if (FVector::DistSquared(Closest, BoundCenter) > BoundRadius * BoundRadius)
+		return false;
+
+	const auto End = Start + Dir * Length;
+	auto bHit = false;
+	OutDist = Length;
+
+	for (auto i = 0; i < History.NumHitboxes; ++i)
+	{
+		const auto BoxStart = FMath::Lerp(A.Start[i], B.Start[i], Alpha);
+		const auto BoxEnd = FMath::Lerp(A.End[i], B.End[i], Alpha);
+
+		FVector OnRay, OnBox;
+		FMath::SegmentDistToSegmentSafe(Start, End, BoxStart, BoxEnd, OnRay, OnBox);
+
+		const auto DistSq = FVector::DistSquared(OnRay, OnBox);
+		const auto RadiusSq = FMath::Square(History.Radii[i]);
+		if (DistSq > RadiusSq)
+			continue;
+
+		const auto Dist = FMath::Max(((OnRay - Start) | Dir) - FMath::Sqrt(RadiusSq - DistSq), 0.0f);
+		if (Dist < OutDist || !bHit)
+		{
+			OutDist = Dist;
+			OutHitbox = i;
+			OutNormal = (Start + Dir * Dist - OnBox).GetSafeNormal();
+			bHit = true;
+		}
+	}
+
+	return bHit;
+}
@@ -0,0 +1,206 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#include "MovementReplayCommandlet.h"
+#include "CP0Character.h"
+#include "CP0CharacterMovement.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "InputCapture.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogMovementReplay, Log, All);
+
+namespace
+{
+	constexpr auto Spacing = 500.0f;
+
+	struct FReplayRunResult
+	{
+		double Seconds = 0.0;
+		uint64 Cycles[FMovementTimers::Num] = {};
+		uint32 Calls[FMovementTimers::Num] = {};
+		uint32 Hash = 0;
+	};
+
+	UWorld* LoadWorld(const FString& MapName)
+	{
+		const auto Package = LoadPackage(nullptr, *MapName, LOAD_None);
+		const auto World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+		if (!World)
+			return nullptr;
+
+		World->WorldType = EWorldType::Game;
+		World->AddToRoot();
+		GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(World);
+
+		if (!World->bIsWorldInitialized)
+			World->InitWorld();
+
+		// 게임 모드 없이 액터들의 BeginPlay만 부른다
+		World->InitializeActorsForPlay(FURL{});
+		World->GetWorldSettings()->NotifyBeginPlay();
+		return World;
+	}
+
+	void UnloadWorld(UWorld* World)
+	{
+		World->DestroyWorld(false);
+		GEngine->DestroyWorldContext(World);
+		World->RemoveFromRoot();
+		CollectGarbage(RF_NoFlags);
+	}
+
+	uint32 HashState(const ACP0Character* Character)
+	{
+		const auto Movement = Character->GetCP0Movement();
+		const auto Location = Character->GetActorLocation();
+		const auto Rotation = Character->GetActorRotation();
+		const auto Velocity = Movement->Velocity;
+
+		uint32 Hash = 0;
+		for (const auto Value : {Location.X, Location.Y, Location.Z, Rotation.Pitch, Rotation.Yaw, Velocity.X,
+		                         Velocity.Y, Velocity.Z, Movement->GetPostureSwitchTimeLeft(),
+		                         Movement->GetMeshPitchOffset()})
+		{
+			Hash = HashCombine(Hash, GetTypeHash(Value));
+		}
+
+		Hash = HashCombine(Hash, GetTypeHash(static_cast<uint8>(Movement->GetPosture())));
+		Hash = HashCombine(Hash, GetTypeHash(Movement->IsActuallySprinting()));
+		return Hash;
+	}
+
+	bool Run(const FInputCapture& Capture, const FString& MapName, UClass* CharacterClass, int32 NumCharacters,
+	         FReplayRunResult& OutResult)
+	{
+		const auto World = LoadWorld(MapName);
+		if (!World)
+		{
+			UE_LOG(LogMovementReplay, Error, TEXT("Failed to load map %s"), *MapName);
+			return false;
+		}
+
+		const auto& Header = Capture.Header;
+		const auto Columns = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumCharacters)));
+
+		TArray<ACP0Character*> Characters;
+		for (auto i = 0; i < NumCharacters; ++i)
+		{
+			const FVector Offset{i % Columns * Spacing, i / Columns * Spacing, 0.0f};
+			FActorSpawnParameters SpawnParams;
+			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+			const auto Character = World->SpawnActor<ACP0Character>(CharacterClass, Header.StartLocation + Offset,
+			                                                        Header.StartRotation, SpawnParams);
+			if (!Character)
+				continue;
+
+			// AI 컨트롤러도 로컬 컨트롤러이므로 엎드린 상태 밀어내기 등 로컬 전용 처리가 그대로 돈다
+			Character->SpawnDefaultController();
+			Character->GetCP0Movement()->RequestPosture(Header.StartPosture);
+			Characters.Add(Character);
+		}
+
+		FMovementTimers::Reset();
+		FMovementTimers::bEnabled = true;
+		const auto StartTime = FPlatformTime::Seconds();
+
+		for (const auto& Frame : Capture.Frames)
+		{
+			for (const auto Character : Characters)
+				Character->ApplyCapturedInput(Frame);
+
+			World->Tick(LEVELTICK_All, Frame.DeltaTime);
+			++GFrameCounter;
+		}
+
+		OutResult.Seconds = FPlatformTime::Seconds() - StartTime;
+		FMovementTimers::bEnabled = false;
+		FMemory::Memcpy(OutResult.Cycles, FMovementTimers::Cycles);
+		FMemory::Memcpy(OutResult.Calls, FMovementTimers::Calls);
+
+		for (const auto Character : Characters)
+			OutResult.Hash = HashCombine(OutResult.Hash, IsValid(Character) ? HashState(Character) : 0);
+
+		UnloadWorld(World);
+		return Characters.Num() > 0;
+	}
+}
+
+UMovementReplayCommandlet::UMovementReplayCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UMovementReplayCommandlet::Main(const FString& Params)
+{
+	FString InputFile;
+	FString MapName = TEXT("/Game/Maps/Dev");
+	FString CharacterClassName;
+	auto NumCharacters = 1;
+	auto NumRuns = 2;
+	FParse::Value(*Params, TEXT("Input="), InputFile);
+	FParse::Value(*Params, TEXT("Map="), MapName);
+	FParse::Value(*Params, TEXT("Character="), CharacterClassName);
+	FParse::Value(*Params, TEXT("Characters="), NumCharacters);
+	FParse::Value(*Params, TEXT("Runs="), NumRuns);
+
+	NumCharacters = FMath::Max(NumCharacters, 1);
+	NumRuns = FMath::Max(NumRuns, 1);
+
+	FInputCapture Capture;
+	if (InputFile.IsEmpty() || !Capture.Load(InputFile))
+	{
+		UE_LOG(LogMovementReplay, Error, TEXT("Usage: -run=MovementReplay -Input=<capture file> [-Map=] [-Character=] "
+			       "[-Characters=1] [-Runs=2]"));
+		return 1;
+	}
+
+	UClass* CharacterClass = ACP0Character::StaticClass();
+	if (!CharacterClassName.IsEmpty())
+	{
+		CharacterClass = LoadClass<ACP0Character>(nullptr, *CharacterClassName);
+		if (!CharacterClass)
+		{
+			UE_LOG(LogMovementReplay, Error, TEXT("Failed to load character class %s"), *CharacterClassName);
+			return 1;
+		}
+	}
+
+	const auto NumFrames = Capture.Frames.Num();
+	TArray<FReplayRunResult> Results;
+	for (auto i = 0; i < NumRuns; ++i)
+	{
+		FReplayRunResult Result;
+		if (!Run(Capture, MapName, CharacterClass, NumCharacters, Result))
+			return 1;
+
+		const auto MsPerFrame = Result.Seconds * 1000.0 / FMath::Max(NumFrames, 1);
+		UE_LOG(LogMovementReplay, Display, TEXT("Run %d: %d characters x %d frames, %.3f ms/frame, hash %08x"),
+		       i, NumCharacters, NumFrames, MsPerFrame, Result.Hash);
+
+		const auto Denom = static_cast<double>(FMath::Max(NumFrames, 1)) * NumCharacters;
+		for (auto Id = 0; Id < FMovementTimers::Num; ++Id)
+		{
+			const auto Ms = FPlatformTime::ToMilliseconds64(Result.Cycles[Id]);
+			UE_LOG(LogMovementReplay, Display, TEXT("  %-20s %10u calls %9.3f ms total %8.4f ms/character/frame"),
+			       FMovementTimers::Names[Id], Result.Calls[Id], Ms, Ms / Denom);
+		}
+
+		Results.Add(Result);
+	}
+
+	for (const auto& Result : Results)
+	{
+		if (Result.Hash != Results[0].Hash)
+		{
+			UE_LOG(LogMovementReplay, Error, TEXT("Movement replay is not deterministic"));
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,101 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#include "Significance.h"
+#include "Camera/PlayerCameraManager.h"
+#include "CP0Character.h"
+#include "GameFramework/PlayerController.h"
+
+void USignificanceSubsystem::Register(ACP0Character* Character)
+{
+	Characters.AddUnique(Character);
+	TimeUntilUpdate = 0.0f;
+}
+
+void USignificanceSubsystem::Unregister(ACP0Character* Character)
+{
+	Characters.RemoveSingleSwap(Character, false);
+}
+
+void USignificanceSubsystem::Tick(float DeltaTime)
+{
+	TimeUntilUpdate -= DeltaTime;
+	if (TimeUntilUpdate > 0.0f)
+		return;
+
+	TimeUntilUpdate = UpdateInterval;
+	Update();
+}
+
+TStatId USignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USignificanceSubsystem, STATGROUP_Tickables);
+}
+
+ETickableTickType USignificanceSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+void USignificanceSubsystem::Update()
+{
+	const auto PC = GetWorld()->GetFirstPlayerController();
+	if (!PC || !PC->PlayerCameraManager)
+		return;
+
+	FVector ViewLoc;
+	FRotator ViewRot;
+	PC->GetPlayerViewPoint(ViewLoc, ViewRot);
+	const auto ViewDir = ViewRot.Vector();
+	const auto ViewTarget = PC->GetViewTarget();
+
+	// 화면 가장자리에서 갑자기 나타나지 않도록 약간 넓게
+	const auto HalfFov = FMath::Min(PC->PlayerCameraManager->GetFOVAngle() * 0.5f + 15.0f, 180.0f);
+	const auto CosHalfFov = FMath::Cos(FMath::DegreesToRadians(HalfFov));
+
+	Characters.RemoveAllSwap([](const TWeakObjectPtr<ACP0Character>& Character) { return !Character.IsValid(); },
+	                         false);
+
+	Ranked.Reset();
+	for (const auto& Ptr : Characters)
+	{
+		const auto Character = Ptr.Get();
+
+		// 관전 중인 대상이나, 스폰 직후 빙의가 복제되어 프록시가 아니게 된 캐릭터
+		if (Character == ViewTarget || Character->GetLocalRole() != ROLE_SimulatedProxy)
+		{
+			Character->SetSignificance(ESignificance::High);
+			continue;
+		}
+
+		const auto ToChar = Character->GetActorLocation() - ViewLoc;
+		const auto Distance = ToChar.Size();
+		const auto bInView = (ToChar | ViewDir) >= CosHalfFov * Distance;
+		const auto bRendered = Character->WasRecentlyRendered(UpdateInterval * 2.0f);
+
+		// 가려졌거나 시야 밖이면서 멀리 있음
+		if (!(bRendered && bInView) && Distance > NearDistance)
+		{
+			Character->SetSignificance(ESignificance::Hidden);
+			continue;
+		}
+
+		const auto Weight = bRendered && bInView ? 4.0f : 1.0f;
+		Ranked.Add({Character, Weight / FMath::Max(Distance, 1.0f), Distance});
+	}
+
+	Ranked.Sort([](const FRanked& A, const FRanked& B) { return A.Score > B.Score; });
+
+	for (auto i = 0; i < Ranked.Num(); ++i)
+	{
+		auto Significance = i < MaxHigh
+			                    ? ESignificance::High
+			                    : i < MaxHigh + MaxMedium
+			                    ? ESignificance::Medium
+			                    : ESignificance::Low;
+
+		if (Ranked[i].Distance > FarDistance)
+			Significance = FMath::Max(Significance, ESignificance::Low);
+
+		Ranked[i].Character->SetSignificance(Significance);
+	}
+}
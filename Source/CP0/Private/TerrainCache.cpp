@@ -0,0 +1,223 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#include "TerrainCache.h"
+#include "Engine/World.h"
+
+namespace
+{
+	constexpr auto Res = FTerrainTile::Res;
+
+	int32 DivFloor(int32 A, int32 B)
+	{
+		return A >= 0 ? A / B : (A - B + 1) / B;
+	}
+
+	int32 GetBand(float Z)
+	{
+		return FMath::FloorToInt(Z / UTerrainCacheSubsystem::BandHeight);
+	}
+
+	FCollisionQueryParams MakeTerrainBakeParams()
+	{
+		FCollisionQueryParams Params{SCENE_QUERY_STAT(TerrainCacheBake), false};
+		Params.MobilityType = EQueryMobilityType::Static;
+		return Params;
+	}
+
+	// 아래 밴드까지 내려가야 밴드 바닥 근처에 있는 캐릭터의 발 밑이 잡힌다
+	void GetTerrainBakeTrace(const FTerrainTileKey& Key, int32 X, int32 Y, FVector& OutStart, FVector& OutEnd)
+	{
+		const auto PX = Key.X * UTerrainCacheSubsystem::TileSize + X * UTerrainCacheSubsystem::CellSize;
+		const auto PY = Key.Y * UTerrainCacheSubsystem::TileSize + Y * UTerrainCacheSubsystem::CellSize;
+		OutStart = {PX, PY, (Key.Band + 1) * UTerrainCacheSubsystem::BandHeight};
+		OutEnd = {PX, PY, (Key.Band - 1) * UTerrainCacheSubsystem::BandHeight};
+	}
+}
+
+bool UTerrainCacheSubsystem::SampleHeight(const FVector& Location, ECollisionChannel Channel, float& OutZ)
+{
+	const auto CX = Location.X / CellSize;
+	const auto CY = Location.Y / CellSize;
+	const auto GX = FMath::FloorToInt(CX);
+	const auto GY = FMath::FloorToInt(CY);
+
+	const FTerrainTileKey Key{DivFloor(GX, Res), DivFloor(GY, Res), GetBand(Location.Z), Channel};
+	const auto* const Tile = FindTile(Key);
+	if (!Tile)
+		return false;
+
+	const auto X = GX - Key.X * Res;
+	const auto Y = GY - Key.Y * Res;
+	if (Tile->Steep[Y] & 1u << X || Tile->Tops[Y * Res + X] > Location.Z)
+		return false;
+
+	const auto* const Row0 = &Tile->Heights[Y * (Res + 1) + X];
+	const auto* const Row1 = Row0 + (Res + 1);
+	OutZ = FMath::BiLerp(Row0[0], Row0[1], Row1[0], Row1[1], CX - GX, CY - GY);
+	return true;
+}
+
+bool UTerrainCacheSubsystem::IsClear(const FVector& Start, const FVector& End, float Radius, ECollisionChannel Channel)
+{
+	const auto Band = GetBand(Start.Z);
+	if (FMath::Max(Start.Z, End.Z) >= (Band + 1) * BandHeight)
+		return false;
+
+	const auto MinZ = FMath::Min(Start.Z, End.Z);
+	const auto GX0 = FMath::FloorToInt((FMath::Min(Start.X, End.X) - Radius) / CellSize);
+	const auto GY0 = FMath::FloorToInt((FMath::Min(Start.Y, End.Y) - Radius) / CellSize);
+	const auto GX1 = FMath::FloorToInt((FMath::Max(Start.X, End.X) + Radius) / CellSize);
+	const auto GY1 = FMath::FloorToInt((FMath::Max(Start.Y, End.Y) + Radius) / CellSize);
+
+	FTerrainTileKey Key{0, 0, Band, Channel};
+	const FTerrainTile* Tile = nullptr;
+	for (auto GY = GY0; GY <= GY1; ++GY)
+	{
+		for (auto GX = GX0; GX <= GX1; ++GX)
+		{
+			const auto TX = DivFloor(GX, Res);
+			const auto TY = DivFloor(GY, Res);
+			if (!Tile || TX != Key.X || TY != Key.Y)
+			{
+				Key.X = TX;
+				Key.Y = TY;
+				Tile = FindTile(Key);
+				if (!Tile)
+					return false;
+			}
+
+			if (Tile->Tops[(GY - TY * Res) * Res + (GX - TX * Res)] >= MinZ)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+void UTerrainCacheSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// 스트리밍으로 정적 지형이 바뀌면 전부 다시 굽는다
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UTerrainCacheSubsystem::OnLevelChanged);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UTerrainCacheSubsystem::OnLevelChanged);
+}
+
+void UTerrainCacheSubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	Super::Deinitialize();
+}
+
+void UTerrainCacheSubsystem::Tick(float DeltaTime)
+{
+	// 지난 틱에 요청한 트레이스는 월드의 비동기 트레이스 버퍼가 프레임 사이에 처리해두었다
+	for (auto& Tile : Baking)
+	{
+		auto Baked = MakeUnique<FTerrainTile>();
+		FinishBake(Tile, *Baked);
+		Tiles.Add(Tile.Key, MoveTemp(Baked));
+	}
+	Baking.Reset();
+
+	// 가장 최근에 요청된 타일부터
+	for (auto i = 0; i < MaxBakesPerTick && BakeQueue.Num() > 0; ++i)
+		RequestBake(BakeQueue.Pop(false), Baking.AddDefaulted_GetRef());
+}
+
+TStatId UTerrainCacheSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTerrainCacheSubsystem, STATGROUP_Tickables);
+}
+
+ETickableTickType UTerrainCacheSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+const FTerrainTile* UTerrainCacheSubsystem::FindTile(const FTerrainTileKey& Key)
+{
+	if (const auto Found = Tiles.Find(Key))
+		return Found->Get();
+
+	Tiles.Add(Key, nullptr);
+	BakeQueue.Add(Key);
+	return nullptr;
+}
+
+void UTerrainCacheSubsystem::RequestBake(const FTerrainTileKey& Key, FBakingTile& Baking) const
+{
+	const auto World = GetWorld();
+	const auto Params = MakeTerrainBakeParams();
+
+	Baking.Key = Key;
+	Baking.Traces.Reset((Res + 1) * (Res + 1));
+	for (auto Y = 0; Y <= Res; ++Y)
+	{
+		for (auto X = 0; X <= Res; ++X)
+		{
+			FVector Start, End;
+			GetTerrainBakeTrace(Key, X, Y, Start, End);
+			Baking.Traces.Add(
+				World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, Key.Channel, Params));
+		}
+	}
+}
+
+void UTerrainCacheSubsystem::FinishBake(const FBakingTile& Baking, FTerrainTile& Tile) const
+{
+	const auto World = GetWorld();
+	const auto& Key = Baking.Key;
+
+	for (auto Y = 0; Y <= Res; ++Y)
+	{
+		for (auto X = 0; X <= Res; ++X)
+		{
+			const auto Idx = Y * (Res + 1) + X;
+			auto bHit = false;
+			FHitResult Hit;
+			FTraceDatum Datum;
+			if (World->QueryTraceData(Baking.Traces[Idx], Datum))
+			{
+				bHit = Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit;
+				if (bHit)
+					Hit = Datum.OutHits[0];
+			}
+			else
+			{
+				// 결과를 잃었으면 (요청한 프레임을 건너뛴 경우 등) 이 점만 직접 검사
+				FVector Start, End;
+				GetTerrainBakeTrace(Key, X, Y, Start, End);
+				bHit = World->LineTraceSingleByChannel(Hit, Start, End, Key.Channel, MakeTerrainBakeParams());
+			}
+			Tile.Heights[Idx] = bHit ? Hit.Location.Z : TNumericLimits<float>::Lowest();
+		}
+	}
+
+	for (auto Y = 0; Y < Res; ++Y)
+	{
+		Tile.Steep[Y] = 0;
+		for (auto X = 0; X < Res; ++X)
+		{
+			const auto* const Row0 = &Tile.Heights[Y * (Res + 1) + X];
+			const auto* const Row1 = Row0 + (Res + 1);
+			const auto Lo = FMath::Min(FMath::Min(Row0[0], Row0[1]), FMath::Min(Row1[0], Row1[1]));
+			const auto Hi = FMath::Max(FMath::Max(Row0[0], Row0[1]), FMath::Max(Row1[0], Row1[1]));
+			Tile.Tops[Y * Res + X] = Hi;
+
+			if (Lo == TNumericLimits<float>::Lowest() || Hi - Lo > MaxStepHeight)
+				Tile.Steep[Y] |= 1u << X;
+		}
+	}
+}
+
+void UTerrainCacheSubsystem::OnLevelChanged(ULevel* Level, UWorld* InWorld)
+{
+	if (InWorld != GetWorld())
+		return;
+
+	Tiles.Reset();
+	BakeQueue.Reset();
+	Baking.Reset();
+}
@@ -1,19 +1,110 @@
 // (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
 
 #include "Weapon.h"
+#include "AnimBudget.h"
+#include "Ballistics.h"
 #include "CP0Character.h"
 #include "CP0CharacterMovement.h"
+#include "CP0ReplicationGraph.h"
+#include "HitAudit.h"
+#include "LagCompensation.h"
 #include "WeaponComponent.h"
+#include "WeaponPool.h"
 #include "GameFramework/PlayerState.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
-AWeapon::AWeapon()
-	: RootScene{CreateDefaultSubobject<USceneComponent>(TEXT("RootScene"))},
-	  Mesh{CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("Mesh"))}
+bool FWeaponFireRecord::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	// Seed 16 | Seq 4 | ShotCount 8 | bFiring 1
+	uint32 Packed = 0;
+	if (Ar.IsSaving())
+		Packed = Seed | (Seq & 0xF) << 16 | ShotCount << 20 | bFiring << 28;
+
+	Ar.SerializeBits(&Packed, 29);
+
+	if (Ar.IsLoading())
+	{
+		Seed = Packed & 0xFFFF;
+		Seq = Packed >> 16 & 0xF;
+		ShotCount = Packed >> 20 & 0xFF;
+		bFiring = Packed >> 28 & 1;
+	}
+
+	bOutSuccess = true;
+	return true;
+}
+
+// 데디케이티드 서버 빌드에서는 무기 메시를 만들지 않는다
+static const FObjectInitializer& StripWeaponCosmetics(const FObjectInitializer& Initializer)
+{
+#if UE_SERVER
+	return Initializer.DoNotCreateDefaultSubobject(TEXT("Mesh"));
+#else
+	return Initializer;
+#endif
+}
+
+bool FClientWeaponCorrectionData::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	// FireMode 2 | bAiming 1
+	uint32 Packed = 0;
+	if (Ar.IsSaving())
+		Packed = (static_cast<uint32>(FireMode) & 3) | bAiming << 2;
+
+	Ar.SerializeBits(&Packed, 3);
+
+	if (Ar.IsLoading())
+	{
+		FireMode = static_cast<EWeaponFireMode>(FMath::Min<uint32>(Packed & 3, 2));
+		bAiming = Packed >> 2 & 1;
+	}
+
+	bOutSuccess = true;
+	return true;
+}
+
+bool FMulticastWeaponCorrectionData::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	// State 2 | bShortClip 1 | Clip 6 (탄창이 64발 미만일 때) 또는 8
+	uint32 Packed = 0;
+	const auto bShortClip = Clip < 64;
+	if (Ar.IsSaving())
+		Packed = (static_cast<uint32>(State) & 3) | bShortClip << 2 | Clip << 3;
+
+	Ar.SerializeBits(&Packed, 3);
+	const auto ClipBits = Packed & 4 ? 6 : 8;
+
+	uint32 PackedClip = Packed >> 3;
+	Ar.SerializeBits(&PackedClip, ClipBits);
+
+	if (Ar.IsLoading())
+	{
+		State = static_cast<EWeaponState>(Packed & 3);
+		Clip = static_cast<uint8>(PackedClip);
+	}
+
+	bOutSuccess = true;
+	return true;
+}
+
+AWeapon::AWeapon(const FObjectInitializer& Initializer)
+	: Super{StripWeaponCosmetics(Initializer)},
+	  RootScene{CreateDefaultSubobject<USceneComponent>(TEXT("RootScene"))},
+	  Mesh{CreateOptionalDefaultSubobject<USkeletalMeshComponent>(TEXT("Mesh"))}
 {
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 	RootComponent = RootScene;
-	Mesh->SetupAttachment(RootScene);
+
+	// 서버에서는 캐릭터에 붙이지 않으므로 무기 위치 대신 소유자 기준으로 판단
+	bNetUseOwnerRelevancy = true;
+
+	if (Mesh)
+	{
+		Mesh->SetupAttachment(RootScene);
+		Mesh->bEnableUpdateRateOptimizations = true;
+	}
 }
 
 ACP0Character* AWeapon::GetCharOwner() const
@@ -36,22 +127,46 @@ void AWeapon::Deploy(ACP0Character* Char)
 	{
 		SetOwner(Char);
 		SetInstigator(Char);
-		RootScene->AttachToComponent(Char->GetMesh(), Rules, GunSock);
 	}
-	if (Char->IsLocallyControlled())
+
+	// 데디케이티드 서버에서는 소유자만 있으면 되고 소켓에 붙일 필요가 없다. 클라이언트는 각자 붙인다
+	if (!IsNetMode(NM_DedicatedServer))
+		RootScene->AttachToComponent(Char->GetMesh(), Rules, GunSock);
+
+	if (Mesh)
 	{
-		Mesh->AttachToComponent(Char->GetArms(), Rules, GunSock);
-		Mesh->SetCastShadow(false);
+		if (Char->IsLocallyControlled() && Char->GetArms())
+		{
+			Mesh->AttachToComponent(Char->GetArms(), Rules, GunSock);
+			Mesh->SetCastShadow(false);
+		}
+		else if (Mesh->GetAttachParent() != RootScene)
+		{
+			// 풀에서 재사용되어 이전에 1인칭 팔에 붙어 있었을 수 있음
+			Mesh->AttachToComponent(RootScene, Rules);
+			Mesh->SetCastShadow(true);
+		}
 	}
 
+	// 다른 캐릭터가 들던 무기일 수 있음. 프록시의 무기라면 UAnimBudgetSubsystem이 다시 낮춘다
+	UAnimBudgetSubsystem::SetUpdateRate(Mesh, 1);
+
 	SetState(EWeaponState::Deploying);
-	Char->GetArms()->SetAnimInstanceClass(ArmsAnimClass);
+	if (const auto Arms = Char->GetArms())
+		Arms->SetAnimInstanceClass(ArmsAnimClass);
 
 	OnDeploy();
 }
 
 void AWeapon::Holster(AWeapon* SwitchTo)
 {
+	// 집어넣는 도중에 다시 바꾸면 먼저 꺼내려던 무기는 쓰이지 않는다
+	if (SwitchingTo && SwitchingTo != SwitchTo && HasAuthority())
+	{
+		if (const auto Pool = GetWorld()->GetSubsystem<UWeaponPoolSubsystem>())
+			Pool->Release(SwitchingTo);
+	}
+
 	SwitchingTo = SwitchTo;
 	SetState(EWeaponState::Holstering);
 	OnHolster();
@@ -61,13 +176,19 @@ void AWeapon::StartFiring()
 {
 	check(GetCharOwner() && GetCharOwner()->IsLocallyControlled());
 
-	if (!bFiring && State == EWeaponState::Ready && CanDoCommonAction())
+	if (!Sim.bFiring && State == EWeaponState::Ready && CanDoCommonAction())
 	{
-		const auto RandSeed = FMath::Rand();
+		const auto RandSeed = static_cast<uint16>(FMath::Rand());
+		ShotTimeOffset = 0.0f;
 		BeginFiring(RandSeed);
 
 		if (!HasAuthority() && GetCharOwner()->IsLocallyControlled())
-			Server_StartFiring(RandSeed);
+		{
+			FWeaponFireRecord Record;
+			Record.Seed = RandSeed;
+			Record.bFiring = true;
+			Server_SetFiring(Record, ULagCompensationSubsystem::GetClientViewTime(GetCharOwner()));
+		}
 	}
 }
 
@@ -75,12 +196,12 @@ void AWeapon::StopFiring()
 {
 	check(GetCharOwner() && GetCharOwner()->IsLocallyControlled());
 
-	if (bFiring && FireMode != EWeaponFireMode::Burst)
+	if (Sim.bFiring && FireMode != EWeaponFireMode::Burst)
 	{
 		EndFiring();
 
 		if (!HasAuthority() && GetCharOwner()->IsLocallyControlled())
-			Server_StopFiring();
+			Server_SetFiring({}, 0.0f);
 	}
 }
 
@@ -88,6 +209,12 @@ void AWeapon::SetAiming(bool bNewAiming)
 {
 	bAiming = bNewAiming;
 	Aiming_LastModified = GetWorld()->GetRealTimeSeconds();
+
+	if (HasAuthority())
+	{
+		MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, bAiming, this);
+		UpdateClientCorrection();
+	}
 }
 
 void AWeapon::Reload()
@@ -102,21 +229,26 @@ void AWeapon::SwitchFireMode()
 {
 	if (FireModes && State == EWeaponState::Ready && CanDoCommonAction())
 	{
-		auto NewFm = static_cast<uint8>(FireMode);
-		do
-		{
-			NewFm = (NewFm + 1) % 3;
-		}
-		while (!(FireModes & 1 << NewFm));
-
 		const auto OldFm = FireMode;
-		SetFireMode(static_cast<EWeaponFireMode>(NewFm));
+		SetFireMode(GetSimParams().GetNextFireMode(FireMode));
 
 		if (OldFm != FireMode)
 			OnFireModeSwitched();
 	}
 }
 
+FWeaponSimParams AWeapon::GetSimParams() const
+{
+	FWeaponSimParams Params;
+	Params.FireDelay = GetFireDelay();
+	Params.ReloadTime_Tactical = ReloadTime_Tactical;
+	Params.ReloadTime_Empty = ReloadTime_Empty;
+	Params.ClipSize = ClipSize;
+	Params.BurstCount = BurstCount;
+	Params.FireModes = FireModes;
+	return Params;
+}
+
 void AWeapon::BeginPlay()
 {
 	Super::BeginPlay();
@@ -126,46 +258,66 @@ void AWeapon::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	if (!GetOwner())
-		return;
-
-	switch (State)
-	{
-	case EWeaponState::Ready:
-		Tick_Ready(DeltaTime);
-		break;
-	case EWeaponState::Reloading:
-		Tick_Reloading(DeltaTime);
-		break;
-	case EWeaponState::Deploying:
-		Tick_Deploying(DeltaTime);
-		break;
-	case EWeaponState::Holstering:
-		Tick_Holstering(DeltaTime);
-		break;
-	default:
-		break;
-	}
-
-	CorrectClientState();
+	// 사격 중일 때만 틱이 켜진다. 나머지 상태 전환은 타이머로 처리
+	if (GetOwner() && Sim.bFiring)
+		Tick_Firing(DeltaTime);
 }
 
 void AWeapon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-	DOREPLIFETIME_CONDITION(AWeapon, FireMode, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(AWeapon, State, COND_SkipOwner);
-	DOREPLIFETIME_CONDITION(AWeapon, bAiming, COND_SkipOwner);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+
+	Params.Condition = COND_SkipOwner;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AWeapon, FireMode, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AWeapon, State, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AWeapon, bAiming, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AWeapon, FireRecord, Params);
+
+	Params.Condition = COND_OwnerOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AWeapon, ClientCorrection, Params);
+
+	Params.Condition = COND_None;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AWeapon, Correction, Params);
+}
+
+void AWeapon::SetOwner(AActor* NewOwner)
+{
+	const auto OldOwner = GetOwner();
+	Super::SetOwner(NewOwner);
+
+	if (OldOwner != NewOwner)
+		UCP0ReplicationGraph::OnWeaponOwnerChanged(this, OldOwner);
+}
+
+#if WITH_EDITOR
+void AWeapon::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	if (HasAnyFlags(RF_ClassDefaultObject))
+		Pattern.Reset();
+}
+#endif
+
+static UAnimInstance* FindAnimInstance(const USkeletalMeshComponent* Comp)
+{
+	return Comp ? Comp->GetAnimInstance() : nullptr;
 }
 
 void AWeapon::PlayMontage(UAnimMontage* ForWeapon, UAnimMontage* ForArms, UAnimMontage* ForBody) const
 {
-	if (const auto AnimInst = Mesh->GetAnimInstance())
+	// 데디케이티드 서버에서는 히트박스에 영향을 주는 몸 몽타주만 재생
+	const auto bCosmetic = !IsNetMode(NM_DedicatedServer);
+
+	if (const auto AnimInst = bCosmetic ? FindAnimInstance(Mesh) : nullptr)
 		AnimInst->Montage_Play(ForWeapon);
 
 	if (const auto Char = GetCharOwner())
 	{
-		if (const auto AnimInst = Char->GetArms()->GetAnimInstance())
+		if (const auto AnimInst = bCosmetic ? FindAnimInstance(Char->GetArms()) : nullptr)
 			AnimInst->Montage_Play(ForArms);
 		if (const auto AnimInst = Char->GetMesh()->GetAnimInstance())
 			AnimInst->Montage_Play(ForBody);
@@ -174,84 +326,131 @@ void AWeapon::PlayMontage(UAnimMontage* ForWeapon, UAnimMontage* ForArms, UAnimM
 
 void AWeapon::StopMontage(float BlendOutTime, UAnimMontage* ForWeapon, UAnimMontage* ForArms, UAnimMontage* ForBody) const
 {
-	if (const auto AnimInst = Mesh->GetAnimInstance())
+	const auto bCosmetic = !IsNetMode(NM_DedicatedServer);
+
+	if (const auto AnimInst = bCosmetic ? FindAnimInstance(Mesh) : nullptr)
 		AnimInst->Montage_Stop(BlendOutTime, ForWeapon);
 
 	if (const auto Char = GetCharOwner())
 	{
-		if (const auto AnimInst = Char->GetArms()->GetAnimInstance())
+		if (const auto AnimInst = bCosmetic ? FindAnimInstance(Char->GetArms()) : nullptr)
 			AnimInst->Montage_Stop(BlendOutTime, ForArms);
 		if (const auto AnimInst = Char->GetMesh()->GetAnimInstance())
 			AnimInst->Montage_Stop(BlendOutTime, ForBody);
 	}
 }
 
-void AWeapon::Tick_Ready(float DeltaTime)
+void AWeapon::TakeFromPool()
+{
+	SetActorHiddenInGame(false);
+	SetNetDormancy(DORM_Awake);
+	ForceNetUpdate();
+}
+
+void AWeapon::ReturnToPool()
 {
-	if (bFiring)
+	if (const auto WepComp = GetWeaponComp())
 	{
-		if (State != EWeaponState::Ready || !CanDoCommonAction())
-		{
-			EndFiring();
-		}
-		else
-		{
-			FireLag += DeltaTime;
-
-			const auto FireDelay = GetFireDelay();
-			while (FireLag >= FireDelay)
-			{
-				FireLag -= FireDelay;
-				if (!Fire())
-				{
-					EndFiring();
-					break;
-				}
-			}
-		}
+		if (WepComp->Weapon == this)
+			WepComp->Weapon = nullptr;
 	}
-	else
+
+	if (Sim.bFiring)
+		EndFiring();
+
+	// 타이머를 먼저 지워서 재장전 취소 이벤트 등이 불리지 않도록
+	GetWorldTimerManager().ClearTimer(StateTimer);
+	GetWorldTimerManager().ClearTimer(ReconcileTimer);
+
+	// 새로 스폰된 것과 같은 상태로
+	const auto CDO = GetClass()->GetDefaultObject<AWeapon>();
+	SetState(CDO->State);
+	SetFireMode(CDO->FireMode);
+	SetClip(CDO->Clip);
+	SetAiming(false);
+	UpdateCorrection();
+
+	Sim = {};
+	SwitchingTo = nullptr;
+	LastShot = {};
+
+	const FAttachmentTransformRules Rules{EAttachmentRule::SnapToTarget, true};
+	RootScene->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
+	if (Mesh)
 	{
-		FireLag = FMath::Min(FireLag + DeltaTime, GetFireDelay());
+		Mesh->AttachToComponent(RootScene, Rules);
+		Mesh->SetCastShadow(true);
 	}
+
+	SetOwner(nullptr);
+	SetInstigator(nullptr);
+	SetActorHiddenInGame(true);
+
+	// 숨김과 소유자 변경이 전송된 뒤 채널이 닫힌다
+	SetNetDormancy(DORM_DormantAll);
 }
 
-void AWeapon::Tick_Reloading(float DeltaTime)
+void AWeapon::Tick_Firing(float DeltaTime)
 {
-	const auto bTactical = Clip > 0;
-	const auto ReloadTime = bTactical ? ReloadTime_Tactical : ReloadTime_Empty;
-	LastStateElapsedTime += DeltaTime;
-	if (LastStateElapsedTime >= ReloadTime)
+	if (State != EWeaponState::Ready || !CanDoCommonAction())
 	{
-		SetClip(ClipSize + bTactical);
-		SetState(EWeaponState::Ready);
+		EndFiring();
+		return;
 	}
+
+	Sim.Advance(GetSimParams(), DeltaTime, [&](float TimeOffset)
+	{
+		return Fire(MakeShot(TimeOffset, DeltaTime));
+	});
+
+	if (Sim.bFiring)
+		UpdateShotBase();
+	else
+		EndFiring();
 }
 
-void AWeapon::Tick_Deploying(float DeltaTime)
+void AWeapon::Complete_Reloading()
 {
-	LastStateElapsedTime += DeltaTime;
-	if (LastStateElapsedTime >= DeployTime)
-	{
-		SetState(EWeaponState::Ready);
-	}
+	// 콜백 안에서는 타이머가 아직 활성 상태로 보이므로, 완료된 것을 취소로 보지 않도록 먼저 지운다
+	GetWorldTimerManager().ClearTimer(StateTimer);
+
+	if (!GetOwner())
+		return;
+
+	SetClip(GetSimParams().GetReloadedClip(Clip));
+	SetState(EWeaponState::Ready);
+}
+
+void AWeapon::Complete_Deploying()
+{
+	GetWorldTimerManager().ClearTimer(StateTimer);
+
+	if (!GetOwner())
+		return;
+
+	SetState(EWeaponState::Ready);
 }
 
-void AWeapon::Tick_Holstering(float DeltaTime)
+void AWeapon::Complete_Holstering()
 {
-	LastStateElapsedTime += DeltaTime;
-	if (LastStateElapsedTime >= HolsterTime)
+	GetWorldTimerManager().ClearTimer(StateTimer);
+
+	if (!GetOwner())
+		return;
+
+	if (HasAuthority())
 	{
-		if (HasAuthority())
+		const auto WepComp = GetWeaponComp();
+		WepComp->Weapon = SwitchingTo;
+		if (WepComp->Weapon)
 		{
-			const auto WepComp = GetWeaponComp();
-			WepComp->Weapon = SwitchingTo;
-			if (WepComp->Weapon)
-			{
-				WepComp->Weapon->Deploy(GetCharOwner());
-			}
-			SwitchingTo = nullptr;
+			WepComp->Weapon->Deploy(GetCharOwner());
 		}
+		SwitchingTo = nullptr;
+
+		// 집어넣은 무기는 더 이상 어디에서도 가리키지 않으므로 다음 사용을 위해 보관
+		if (const auto Pool = GetWorld()->GetSubsystem<UWeaponPoolSubsystem>())
+			Pool->Release(this);
 	}
 }
 
@@ -261,16 +460,19 @@ void AWeapon::Enter_Ready()
 
 void AWeapon::Enter_Reloading()
 {
+	SetStateTimer(GetSimParams().GetReloadTime(Clip), &AWeapon::Complete_Reloading);
 	OnReloadStart(Clip <= 0);
 }
 
 void AWeapon::Enter_Deploying()
 {
 	// 이 시점에는 아직 Owner가 설정되지 않았을 수도 있기 때문에, 웬만하면 Deploy() 함수에서 처리
+	SetStateTimer(DeployTime, &AWeapon::Complete_Deploying);
 }
 
 void AWeapon::Enter_Holstering()
 {
+	SetStateTimer(HolsterTime, &AWeapon::Complete_Holstering);
 	OnHolster();
 }
 
@@ -280,7 +482,7 @@ void AWeapon::Exit_Ready()
 
 void AWeapon::Exit_Reloading()
 {
-	if (LastStateElapsedTime != 0.0f)
+	if (GetWorldTimerManager().IsTimerActive(StateTimer))
 	{
 		OnReloadCancelled();
 	}
@@ -294,58 +496,184 @@ void AWeapon::Exit_Holstering()
 {
 }
 
-void AWeapon::BeginFiring(int32 RandSeed)
+void AWeapon::BeginFiring(uint16 RandSeed)
 {
-	CurBurstCount = 0;
-	FireRand.Initialize(RandSeed);
-	bFiring = true;
+	// 틱이 꺼져 있던 동안 쌓였을 FireLag를 한꺼번에 반영
+	const auto Now = GetWorld()->GetTimeSeconds();
+	const auto Params = GetSimParams();
+	Sim.Idle(Params, Now - FireLagTime);
+	FireLagTime = Now;
 
-	const auto FireDelay = GetFireDelay();
-	if (FireLag >= FireDelay)
-	{
-		FireLag -= FireDelay;
+	const auto bFireNow = Sim.BeginFiring(Params, RandSeed);
+	SetActorTickEnabled(true);
+	UpdateShotBase();
 
-		if (!Fire())
-			EndFiring();
+	if (HasAuthority())
+	{
+		FireRecord.Seed = RandSeed;
+		FireRecord.Seq = (FireRecord.Seq + 1) % 16;
+		FireRecord.ShotCount = 0;
+		FireRecord.bFiring = true;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, FireRecord, this);
+		Audit(EHitAuditEvent::BeginFiring, Now);
 	}
+
+	if (bFireNow && !Fire(MakeShot(0.0f, 0.0f)))
+		EndFiring();
 }
 
 void AWeapon::EndFiring()
 {
-	bFiring = false;
-	CurBurstCount = 0;
+	Sim.EndFiring();
+	FireLagTime = GetWorld()->GetTimeSeconds();
+	SetActorTickEnabled(false);
+
+	if (HasAuthority())
+	{
+		FireRecord.ShotCount = Sim.ShotCount;
+		FireRecord.bFiring = false;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, FireRecord, this);
+
+		// 발사 중에는 클라이언트들도 같은 시드로 시뮬레이션하므로 탄 수는 사격이 끝났을 때만 보정
+		UpdateCorrection();
+	}
 }
 
-bool AWeapon::Fire()
+const FWeaponPattern& AWeapon::GetPattern() const
 {
-	if (Clip == 0)
+	const auto CDO = GetClass()->GetDefaultObject<AWeapon>();
+	if (!CDO->Pattern)
+	{
+		// 이름 해시는 프로세스마다 다르므로 경로 문자열의 CRC를 시드로 사용
+		CDO->Pattern = MakeUnique<FWeaponPattern>();
+		CDO->Pattern->Build(FCrc::StrCrc32(*GetClass()->GetPathName()), CDO->RecoilPitch, CDO->RecoilYaw);
+	}
+	return *CDO->Pattern;
+}
+
+FWeaponShot AWeapon::MakeShot(float TimeOffset, float DeltaTime) const
+{
+	const auto Char = GetCharOwner();
+	const auto Alpha = DeltaTime > 0.0f ? FMath::Clamp(1.0f - TimeOffset / DeltaTime, 0.0f, 1.0f) : 1.0f;
+
+	FWeaponShot Shot;
+	Shot.Time = GetWorld()->GetTimeSeconds() - TimeOffset;
+	Shot.TimeOffset = TimeOffset;
+	Shot.Origin = FMath::Lerp(PrevShotOrigin, Char->GetPawnViewLocation(), Alpha);
+	Shot.Aim = FMath::Lerp(PrevShotAim, Char->GetBaseAimRotation(), Alpha);
+
+	const auto Deviation = GetPattern().GetDeviation(Sim.Seed, Sim.ShotCount, bAiming ? AimSpread : HipSpread);
+	Shot.Deviation = {Deviation.X, Deviation.Y, 0.0f};
+	Shot.Aim += Shot.Deviation;
+	return Shot;
+}
+
+void AWeapon::UpdateShotBase()
+{
+	if (const auto Char = GetCharOwner())
+	{
+		PrevShotOrigin = Char->GetPawnViewLocation();
+		PrevShotAim = Char->GetBaseAimRotation();
+	}
+}
+
+bool AWeapon::Fire(const FWeaponShot& Shot)
+{
+	auto NewClip = Clip;
+	const auto Result = Sim.Fire(GetSimParams(), FireMode, NewClip);
+	if (Result == EWeaponFireResult::Dry)
 	{
 		OnDryFire();
 		return false;
 	}
 
-	SetClip(Clip - 1);
+	SetClip(NewClip);
 
-	if (FireMode == EWeaponFireMode::Burst)
-		CurBurstCount++;
+	LastShot = Shot;
+	if (HasAuthority())
+		ResolveShot(Shot);
 
 	OnFire();
 
-	if (Clip == 0)
-	{
+	if (Result == EWeaponFireResult::Empty)
 		OnDryFire();
-		return false;
+
+	return Result == EWeaponFireResult::Continue;
+}
+
+void AWeapon::ResolveShot(const FWeaponShot& Shot)
+{
+	const auto Char = GetCharOwner();
+	const auto World = GetWorld();
+
+	if (MuzzleVelocity > 0.0f)
+	{
+		if (const auto Ballistics = World->GetSubsystem<UBallisticsSubsystem>())
+		{
+			const auto Velocity = Shot.Aim.Vector() * MuzzleVelocity;
+			Ballistics->Launch(this, Shot.Origin, Velocity, Drag, Range, Shot.TimeOffset, ShotTimeOffset);
+			Audit(EHitAuditEvent::Shot, Shot.Time);
+			return;
+		}
 	}
 
-	switch (FireMode)
+	const auto Start = Shot.Origin;
+	const auto End = Start + Shot.Aim.Vector() * Range;
+
+	FCollisionQueryParams Params{TEXT("WeaponShot"), true, Char};
+	Params.AddIgnoredActor(this);
+
+	// 캐릭터는 Visibility 채널을 무시하므로 여기서는 지형지물만 걸린다
+	FHitResult Hit;
+	const auto bBlocked = World->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility, Params);
+
+	auto bHitChar = false;
+	if (const auto LagComp = World->GetSubsystem<ULagCompensationSubsystem>())
 	{
-	case EWeaponFireMode::SemiAuto:
-		return false;
-	case EWeaponFireMode::Burst:
-		return CurBurstCount < BurstCount;
-	default:
-		return true;
+		const auto ShotTime = Shot.Time - ShotTimeOffset;
+		bHitChar = LagComp->Trace(Start, bBlocked ? Hit.Location : End, ShotTime, Char, Hit);
+	}
+
+	if (bBlocked || bHitChar)
+		OnFireHit(Hit);
+
+	// 발사는 Shot, 명중은 Hit으로 따로 남긴다. 투사체도 발사 때 Shot, 맞을 때 Hit을 남긴다
+	Audit(EHitAuditEvent::Shot, Shot.Time, bBlocked && !bHitChar ? &Hit : nullptr);
+	if (bHitChar)
+		Audit(EHitAuditEvent::Hit, Shot.Time, &Hit);
+}
+
+void AWeapon::Audit(EHitAuditEvent Event, float Time, const FHitResult* Hit) const
+{
+	if (!FHitAudit::IsEnabled())
+		return;
+
+	const auto GetPlayerId = [](const AActor* Actor)
+	{
+		const auto Pawn = Cast<APawn>(Actor);
+		const auto PS = Pawn ? Pawn->GetPlayerState() : nullptr;
+		return PS ? PS->GetPlayerId() : INDEX_NONE;
+	};
+
+	const auto Char = GetCharOwner();
+
+	FHitAuditRecord Rec;
+	Rec.Time = Time;
+	Rec.ShooterId = GetPlayerId(Char);
+	Rec.ShooterPos = Char ? Char->GetPawnViewLocation() : GetActorLocation();
+	Rec.Seed = static_cast<uint16>(Sim.Seed);
+	Rec.Event = Event;
+	Rec.ShotIndex = Sim.ShotCount;
+	Rec.Clip = Clip;
+	Rec.State = static_cast<uint8>(State);
+
+	if (Hit)
+	{
+		Rec.TargetId = GetPlayerId(Hit->GetActor());
+		Rec.TargetPos = Hit->Location;
 	}
+
+	FHitAudit::Record(Rec);
 }
 
 bool AWeapon::CanDoCommonAction() const
@@ -382,9 +710,15 @@ void AWeapon::SetState(EWeaponState NewState)
 		break;
 	}
 
+	GetWorldTimerManager().ClearTimer(StateTimer);
 	State = NewState;
 	State_LastModified = GetWorld()->GetRealTimeSeconds();
-	LastStateElapsedTime = 0.0f;
+
+	if (HasAuthority())
+	{
+		MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, State, this);
+		UpdateCorrection();
+	}
 
 	switch (State)
 	{
@@ -407,20 +741,69 @@ void AWeapon::SetFireMode(EWeaponFireMode NewFm)
 {
 	FireMode = NewFm;
 	FireMode_LastModified = GetWorld()->GetRealTimeSeconds();
+
+	if (HasAuthority())
+	{
+		MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, FireMode, this);
+		UpdateClientCorrection();
+	}
 }
 
-void AWeapon::CorrectClientState()
+void AWeapon::SetStateTimer(float Time, void (AWeapon::*Callback)())
 {
-	if (GetOwner()->GetRemoteRole() != ROLE_AutonomousProxy)
-		return;
+	// 0 이하의 시간으로 SetTimer를 호출하면 타이머가 설정되지 않으므로 최소한 다음 프레임에 실행되도록
+	GetWorldTimerManager().SetTimer(StateTimer, this, Callback, FMath::Max(Time, KINDA_SMALL_NUMBER));
+}
+
+void AWeapon::UpdateClientCorrection()
+{
+	ClientCorrection.FireMode = FireMode;
+	ClientCorrection.bAiming = bAiming;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, ClientCorrection, this);
+}
+
+void AWeapon::UpdateCorrection()
+{
+	Correction.Clip = Clip;
+	Correction.State = State;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AWeapon, Correction, this);
+	Audit(EHitAuditEvent::Correction, GetWorld()->GetTimeSeconds());
+}
+
+void AWeapon::ReconcileWithServer()
+{
+	// 로컬에서 최근에 바꾼 값은 서버에 반영될 때까지 기다렸다가 다시 확인
+	auto bPending = false;
+	const auto ShouldCorrect = [&](bool bDiffers, float LastModified)
+	{
+		if (!bDiffers)
+			return false;
 
-	const auto Now = GetWorld()->GetRealTimeSeconds();
-	if (NextCorrection <= Now)
+		if (IsExpired(LastModified))
+			return true;
+
+		bPending = true;
+		return false;
+	};
+
+	const auto Char = GetCharOwner();
+	if (Char && Char->IsLocallyControlled())
 	{
-		Client_CorrectState({FireMode, bAiming});
-		Multicast_CorrectState({Clip, State});
-		NextCorrection = Now + 0.5f;
+		if (ShouldCorrect(FireMode != ClientCorrection.FireMode, FireMode_LastModified))
+			FireMode = ClientCorrection.FireMode;
+
+		if (ShouldCorrect(bAiming != ClientCorrection.bAiming, Aiming_LastModified))
+			bAiming = ClientCorrection.bAiming;
 	}
+
+	if (ShouldCorrect(Clip != Correction.Clip, Sim.bFiring ? GetWorld()->GetRealTimeSeconds() : Clip_LastModified))
+		Clip = Correction.Clip;
+
+	if (ShouldCorrect(State != Correction.State, State_LastModified))
+		SetState(Correction.State);
+
+	if (bPending)
+		GetWorldTimerManager().SetTimer(ReconcileTimer, this, &AWeapon::ReconcileWithServer, 0.1f);
 }
 
 bool AWeapon::IsExpired(float LastModified) const
@@ -437,66 +820,68 @@ bool AWeapon::IsExpired(float LastModified) const
 	return true;
 }
 
-void AWeapon::Client_CorrectState_Implementation(FClientWeaponCorrectionData Data)
+void AWeapon::OnRep_ClientCorrection()
 {
-	if (FireMode != Data.FireMode && IsExpired(FireMode_LastModified))
-		FireMode = Data.FireMode;
-
-	if (bAiming != Data.bAiming && IsExpired(Aiming_LastModified))
-		bAiming = Data.bAiming;
+	ReconcileWithServer();
 }
 
-void AWeapon::Multicast_CorrectState_Implementation(FMulticastWeaponCorrectionData Data)
+void AWeapon::OnRep_Correction()
 {
-	if (Clip != Data.Clip && IsExpired(Clip_LastModified))
-		Clip = Data.Clip;
-
-	if (State != Data.State && IsExpired(State_LastModified))
-		SetState(Data.State);
+	ReconcileWithServer();
 }
 
-void AWeapon::Server_StartFiring_Implementation(int32 RandSeed)
+void AWeapon::Server_SetFiring_Implementation(FWeaponFireRecord Record, float ViewTime)
 {
-	BeginFiring(RandSeed);
-	Multicast_StartFiring(RandSeed);
+	if (Record.bFiring)
+	{
+		const auto Offset = GetWorld()->GetTimeSeconds() - ViewTime;
+		ShotTimeOffset = FMath::Clamp(Offset, 0.0f, ULagCompensationSubsystem::MaxRewindTime);
+
+		if (Sim.bFiring)
+			EndFiring();
+		BeginFiring(Record.Seed);
+	}
+	else if (Sim.bFiring)
+	{
+		EndFiring();
+	}
 }
 
-bool AWeapon::Server_StartFiring_Validate(int32 RandSeed)
+bool AWeapon::Server_SetFiring_Validate(FWeaponFireRecord Record, float ViewTime)
 {
 	return true;
 }
 
-void AWeapon::Multicast_StartFiring_Implementation(int32 RandSeed)
+void AWeapon::OnRep_FireRecord(const FWeaponFireRecord& Prev)
 {
-	if (HasAuthority())
+	const auto Char = GetCharOwner();
+	if (!Char || Char->IsLocallyControlled())
 		return;
 
-	const auto Char = GetCharOwner();
-	if (Char && !Char->IsLocallyControlled())
+	// 처음 관련성을 얻었을 때는 Prev가 기본값이다. 쏘는 중이면 지금부터 이어서 쏘고, 끝난 연사는 다시 쏘지 않는다
+	if (!bFireRecordReceived)
 	{
-		BeginFiring(RandSeed);
+		bFireRecordReceived = true;
+		if (FireRecord.bFiring)
+			BeginFiring(FireRecord.Seed);
+		return;
 	}
-}
 
-void AWeapon::Server_StopFiring_Implementation()
-{
-	EndFiring();
-	Multicast_StopFiring();
-}
-
-bool AWeapon::Server_StopFiring_Validate()
-{
-	return true;
-}
-
-void AWeapon::Multicast_StopFiring_Implementation()
-{
-	if (HasAuthority())
-		return;
+	if (FireRecord.Seq != Prev.Seq)
+	{
+		if (Sim.bFiring)
+			EndFiring();
+		BeginFiring(FireRecord.Seed);
+	}
 
-	const auto Char = GetCharOwner();
-	if (Char && !Char->IsLocallyControlled())
+	if (!FireRecord.bFiring && Sim.bFiring)
 	{
+		// 짧게 끊어 쏘면 시작과 중지가 한 번에 도착하므로, 서버에서 발사된 만큼은 채워서 쏜다
+		while (Sim.ShotCount < FireRecord.ShotCount)
+		{
+			if (!Fire(MakeShot(0.0f, 0.0f)))
+				break;
+		}
 		EndFiring();
 	}
 }
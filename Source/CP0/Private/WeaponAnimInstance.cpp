@@ -3,13 +3,21 @@
 #include "WeaponAnimInstance.h"
 #include "Weapon.h"
 
-void UWeaponAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
+void FWeaponAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
 {
-	Super::NativeUpdateAnimation(DeltaSeconds);
+	Super::PreUpdate(InAnimInstance, DeltaSeconds);
 
-	const auto Weapon = Cast<AWeapon>(GetOwningActor());
-	if (!Weapon)
-		return;
+	if (const auto Weapon = Cast<AWeapon>(InAnimInstance->GetOwningActor()))
+		FireMode = Weapon->GetFireMode();
+}
 
-	FireMode = Weapon->GetFireMode();
+void FWeaponAnimInstanceProxy::Update(float DeltaSeconds)
+{
+	Super::Update(DeltaSeconds);
+	CastChecked<UWeaponAnimInstance>(GetAnimInstanceObject())->FireMode = FireMode;
+}
+
+FAnimInstanceProxy* UWeaponAnimInstance::CreateAnimInstanceProxy()
+{
+	return new FWeaponAnimInstanceProxy{this};
 }
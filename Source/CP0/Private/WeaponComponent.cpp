@@ -4,6 +4,7 @@
 #include "CP0Character.h"
 #include "Net/UnrealNetwork.h"
 #include "Weapon.h"
+#include "WeaponPool.h"
 
 UWeaponComponent::UWeaponComponent()
 {
@@ -20,6 +21,30 @@ const UWeaponComponent* UWeaponComponent::GetDefaultSelf() const
 	return GetDefault<ACP0Character>(GetOwner()->GetClass())->GetWeaponComp();
 }
 
+void UWeaponComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (DefaultWeaponClass && !Weapon && GetOwner()->HasAuthority())
+		EquipWeaponOfClass(DefaultWeaponClass);
+}
+
+void UWeaponComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// 캐릭터가 파괴되면 들고 있던 무기와 바꾸려던 무기는 다음 리스폰에서 재사용
+	if (Weapon && EndPlayReason == EEndPlayReason::Destroyed && GetOwner()->HasAuthority())
+	{
+		if (const auto Pool = GetWorld()->GetSubsystem<UWeaponPoolSubsystem>())
+		{
+			// Release가 SwitchingTo를 지우므로 먼저
+			Pool->Release(Weapon->SwitchingTo);
+			Pool->Release(Weapon);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void UWeaponComponent::TickComponent(float DeltaTime, ELevelTick TickType,
                                      FActorComponentTickFunction* ThisTickFunction)
 {
@@ -53,6 +78,19 @@ void UWeaponComponent::EquipWeapon(AWeapon* NewWeapon)
 	}
 }
 
+AWeapon* UWeaponComponent::EquipWeaponOfClass(TSubclassOf<AWeapon> Class)
+{
+	const auto Pool = GetWorld()->GetSubsystem<UWeaponPoolSubsystem>();
+	if (!Pool || !GetOwner()->HasAuthority())
+		return nullptr;
+
+	const auto NewWeapon = Pool->Acquire(Class, GetOwner()->GetActorTransform());
+	if (NewWeapon)
+		EquipWeapon(NewWeapon);
+
+	return NewWeapon;
+}
+
 void FInputAction_Fire::Enable(ACP0Character* Character)
 {
 	if (const auto Weapon = Character->GetWeaponComp()->GetWeapon())
@@ -0,0 +1,67 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#include "WeaponPool.h"
+#include "Weapon.h"
+
+AWeapon* UWeaponPoolSubsystem::Acquire(TSubclassOf<AWeapon> Class, const FTransform& Transform)
+{
+	if (!Class)
+		return nullptr;
+
+	if (const auto Bucket = Buckets.Find(Class))
+	{
+		while (Bucket->Weapons.Num() > 0)
+		{
+			const auto Weapon = Bucket->Weapons.Pop(false);
+			if (IsValid(Weapon))
+			{
+				Weapon->SetActorTransform(Transform);
+				Weapon->TakeFromPool();
+				return Weapon;
+			}
+		}
+	}
+
+	return Spawn(Class, Transform);
+}
+
+void UWeaponPoolSubsystem::Release(AWeapon* Weapon)
+{
+	if (!IsValid(Weapon) || !Weapon->HasAuthority())
+		return;
+
+	auto& Bucket = Buckets.FindOrAdd(Weapon->GetClass());
+	if (Bucket.Weapons.Num() >= MaxPooledPerClass)
+	{
+		Weapon->Destroy();
+		return;
+	}
+
+	Weapon->ReturnToPool();
+	Bucket.Weapons.Add(Weapon);
+}
+
+void UWeaponPoolSubsystem::Prewarm(TSubclassOf<AWeapon> Class, int32 Count)
+{
+	if (!Class)
+		return;
+
+	auto& Bucket = Buckets.FindOrAdd(Class);
+	Count = FMath::Min(Count, MaxPooledPerClass);
+	while (Bucket.Weapons.Num() < Count)
+	{
+		const auto Weapon = Spawn(Class, FTransform::Identity);
+		if (!Weapon)
+			break;
+
+		Weapon->ReturnToPool();
+		Bucket.Weapons.Add(Weapon);
+	}
+}
+
+AWeapon* UWeaponPoolSubsystem::Spawn(TSubclassOf<AWeapon> Class, const FTransform& Transform) const
+{
+	FActorSpawnParameters Params;
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return GetWorld()->SpawnActor<AWeapon>(Class, Transform, Params);
+}
@@ -0,0 +1,93 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#include "WeaponSim.h"
+
+EWeaponFireMode FWeaponSimParams::GetNextFireMode(EWeaponFireMode FireMode) const
+{
+	if (!FireModes)
+		return FireMode;
+
+	auto NewFm = static_cast<uint8>(FireMode);
+	do
+	{
+		NewFm = (NewFm + 1) % 3;
+	}
+	while (!(FireModes & 1 << NewFm));
+
+	return static_cast<EWeaponFireMode>(NewFm);
+}
+
+void FWeaponPattern::Build(uint32 Seed, float RecoilPitch, float RecoilYaw)
+{
+	FRandomStream Rand{static_cast<int32>(Seed)};
+
+	for (auto& Dir : Spread)
+	{
+		do
+		{
+			Dir = {Rand.FRandRange(-1.0f, 1.0f), Rand.FRandRange(-1.0f, 1.0f)};
+		}
+		while (Dir.SizeSquared() > 1.0f);
+	}
+
+	// 첫 발은 반동 없이 나간다
+	FVector2D Sum{0.0f, 0.0f};
+	for (auto& Kick : Recoil)
+	{
+		Kick = Sum;
+		Sum.X += RecoilPitch * Rand.FRandRange(0.8f, 1.2f);
+		Sum.Y += RecoilYaw * Rand.FRandRange(-1.0f, 1.0f);
+	}
+}
+
+bool FWeaponSim::BeginFiring(const FWeaponSimParams& Params, int32 InSeed)
+{
+	CurBurstCount = 0;
+	ShotCount = 0;
+	Seed = InSeed;
+	bFiring = true;
+
+	if (FireLag < Params.FireDelay)
+		return false;
+
+	FireLag -= Params.FireDelay;
+	return true;
+}
+
+void FWeaponSim::EndFiring()
+{
+	bFiring = false;
+	CurBurstCount = 0;
+}
+
+void FWeaponSim::Idle(const FWeaponSimParams& Params, float DeltaTime)
+{
+	FireLag = FMath::Min(FireLag + DeltaTime, Params.FireDelay);
+}
+
+EWeaponFireResult FWeaponSim::Fire(const FWeaponSimParams& Params, EWeaponFireMode FireMode, uint8& Clip)
+{
+	if (Clip == 0)
+		return EWeaponFireResult::Dry;
+
+	--Clip;
+
+	if (FireMode == EWeaponFireMode::Burst)
+		CurBurstCount++;
+
+	if (ShotCount < MAX_uint8)
+		ShotCount++;
+
+	if (Clip == 0)
+		return EWeaponFireResult::Empty;
+
+	switch (FireMode)
+	{
+	case EWeaponFireMode::SemiAuto:
+		return EWeaponFireResult::Stop;
+	case EWeaponFireMode::Burst:
+		return CurBurstCount < Params.BurstCount ? EWeaponFireResult::Continue : EWeaponFireResult::Stop;
+	default:
+		return EWeaponFireResult::Continue;
+	}
+}
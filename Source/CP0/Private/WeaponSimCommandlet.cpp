@@ -0,0 +1,155 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#include "WeaponSimCommandlet.h"
+#include "WeaponSim.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWeaponSim, Log, All);
+
+namespace
+{
+	struct FSimWeapon
+	{
+		FWeaponSim Sim;
+		float ReloadLeft = 0.0f;
+		float TriggerPeriod = 0.0f;
+		float TriggerHold = 0.0f;
+		float TriggerPhase = 0.0f;
+		uint8 Clip = 0;
+		EWeaponFireMode FireMode = EWeaponFireMode::SemiAuto;
+		bool bTrigger = false;
+	};
+
+	struct FRunResult
+	{
+		double Seconds = 0.0;
+		uint64 Shots = 0;
+		uint32 Hash = 0;
+	};
+
+	FRunResult Run(const FWeaponSimParams& Params, int32 NumWeapons, int32 NumFrames, float DeltaTime, int32 Seed)
+	{
+		// 방아쇠 입력은 프레임 수가 아닌 시간 기준이므로 틱 주기가 달라도 같은 패턴이 된다
+		FRandomStream Rand{Seed};
+		TArray<FSimWeapon> Weapons;
+		Weapons.SetNum(NumWeapons);
+		for (auto& W : Weapons)
+		{
+			W.Clip = Params.ClipSize;
+			W.FireMode = static_cast<EWeaponFireMode>(Rand.RandHelper(3));
+			W.TriggerPeriod = Rand.FRandRange(0.3f, 2.0f);
+			W.TriggerHold = W.TriggerPeriod * Rand.FRandRange(0.1f, 0.9f);
+			W.TriggerPhase = Rand.FRandRange(0.0f, W.TriggerPeriod);
+		}
+
+		FRunResult Result;
+		const auto StartTime = FPlatformTime::Seconds();
+
+		for (auto Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const auto Time = Frame * DeltaTime;
+			for (auto i = 0; i < NumWeapons; ++i)
+			{
+				auto& W = Weapons[i];
+				const auto bTrigger = FMath::Fmod(Time + W.TriggerPhase, W.TriggerPeriod) < W.TriggerHold;
+				const auto bPressed = bTrigger && !W.bTrigger;
+				const auto bReleased = !bTrigger && W.bTrigger;
+				W.bTrigger = bTrigger;
+
+				const auto Shoot = [&](float)
+				{
+					const auto FireResult = W.Sim.Fire(Params, W.FireMode, W.Clip);
+					if (FireResult == EWeaponFireResult::Dry)
+						return false;
+
+					++Result.Shots;
+					return FireResult == EWeaponFireResult::Continue;
+				};
+
+				if (W.ReloadLeft > 0.0f)
+				{
+					W.ReloadLeft -= DeltaTime;
+					if (W.ReloadLeft <= 0.0f)
+						W.Clip = Params.GetReloadedClip(W.Clip);
+				}
+				else if (bPressed && !W.Sim.bFiring)
+				{
+					if (W.Sim.BeginFiring(Params, HashCombine(Seed, i)) && !Shoot(0.0f))
+						W.Sim.EndFiring();
+				}
+				else if (bReleased && W.Sim.bFiring && W.FireMode != EWeaponFireMode::Burst)
+				{
+					W.Sim.EndFiring();
+				}
+
+				if (W.Sim.bFiring)
+					W.Sim.Advance(Params, DeltaTime, Shoot);
+				else
+					W.Sim.Idle(Params, DeltaTime);
+
+				if (W.Clip == 0 && !W.Sim.bFiring && W.ReloadLeft <= 0.0f)
+					W.ReloadLeft = Params.GetReloadTime(W.Clip);
+			}
+		}
+
+		Result.Seconds = FPlatformTime::Seconds() - StartTime;
+
+		for (const auto& W : Weapons)
+		{
+			Result.Hash = HashCombine(Result.Hash, GetTypeHash(W.Clip));
+			Result.Hash = HashCombine(Result.Hash, GetTypeHash(W.Sim.ShotCount));
+			Result.Hash = HashCombine(Result.Hash, GetTypeHash(W.Sim.FireLag));
+			Result.Hash = HashCombine(Result.Hash, GetTypeHash(W.Sim.bFiring));
+		}
+		Result.Hash = HashCombine(Result.Hash, GetTypeHash(Result.Shots));
+		return Result;
+	}
+}
+
+UWeaponSimCommandlet::UWeaponSimCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UWeaponSimCommandlet::Main(const FString& Params)
+{
+	auto NumWeapons = 100000;
+	auto NumFrames = 600;
+	auto Hz = 30.0f;
+	auto Seed = 1;
+	FParse::Value(*Params, TEXT("Weapons="), NumWeapons);
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("Hz="), Hz);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+
+	NumWeapons = FMath::Max(NumWeapons, 1);
+	NumFrames = FMath::Max(NumFrames, 1);
+	Hz = FMath::Max(Hz, 1.0f);
+
+	FWeaponSimParams SimParams;
+	SimParams.FireModes = 0b111;
+
+	const auto DeltaTime = 1.0f / Hz;
+	const FRunResult Results[] = {
+		Run(SimParams, NumWeapons, NumFrames, DeltaTime, Seed),
+		Run(SimParams, NumWeapons, NumFrames, DeltaTime, Seed)
+	};
+
+	for (const auto& Result : Results)
+	{
+		const auto MsPerFrame = Result.Seconds * 1000.0 / NumFrames;
+		UE_LOG(LogWeaponSim, Display,
+		       TEXT("%d weapons x %d frames @ %.0fHz: %.3f ms/frame (%.1f ns/weapon), %llu shots, hash %08x"),
+		       NumWeapons, NumFrames, Hz, MsPerFrame, MsPerFrame * 1e6 / NumWeapons, Result.Shots, Result.Hash);
+	}
+
+	if (Results[0].Hash != Results[1].Hash)
+	{
+		UE_LOG(LogWeaponSim, Error, TEXT("Simulation is not deterministic"));
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,90 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#pragma once
+
+#include "CP0.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "AnimBudget.generated.h"
+
+class ACP0Character;
+
+DECLARE_STATS_GROUP(TEXT("CP0 Anim Budget"), STATGROUP_CP0AnimBudget, STATCAT_Advanced);
+
+// 애님 프록시들이 작업 스레드에서 쓴 시간. 여러 스레드에서 동시에 더해진다
+struct FAnimBudgetCounter
+{
+	TAtomic<uint64> Cycles{0};
+	TAtomic<uint32> Evaluations{0};
+};
+
+/**
+ * 그래프 갱신과 포즈 계산에 걸린 시간을 UAnimBudgetSubsystem에 알리는 프록시. CP0 애님 인스턴스의 프록시는 모두 이것을 상속한다.
+ */
+USTRUCT()
+struct FBudgetedAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FBudgetedAnimInstanceProxy() = default;
+
+	explicit FBudgetedAnimInstanceProxy(UAnimInstance* Instance) : FAnimInstanceProxy{Instance}
+	{
+	}
+
+protected:
+	void Initialize(UAnimInstance* InAnimInstance) override;
+	void UpdateAnimationNode(const FAnimationUpdateContext& InContext) override;
+	void EvaluateAnimationNode(FPoseContext& Output) override;
+
+private:
+	FAnimBudgetCounter* BudgetCounter = nullptr;
+};
+
+/**
+ * 클라이언트 전용. 다른 플레이어 캐릭터(몸, 팔)와 들고 있는 무기의 애니메이션 갱신 빈도를 중요도에 따라 낮춘다.
+ * 건너뛴 프레임은 엔진의 업데이트 빈도 최적화(URO)로 보간한다. 애니메이션에 쓴 시간이 예산을 넘으면 화면 밖이나
+ * 먼 캐릭터부터 빈도를 더 낮추고, 여유가 생기면 되돌린다. 현황은 stat CP0AnimBudget 참고.
+ */
+UCLASS()
+class CP0_API UAnimBudgetSubsystem final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr auto UpdateInterval = 0.2f;
+	static constexpr auto MaxPressure = 4;
+	static constexpr auto MaxUpdateRate = 16;
+
+	// 예산을 넘거나 남을 때 압력을 한 단계씩 바꾸는 최소 간격
+	static constexpr auto PressureInterval = 0.5f;
+
+	static FAnimBudgetCounter* GetCounter(const UWorld* World);
+
+	// Rate 프레임마다 한 번 갱신. 1이면 매 프레임이고 화면 밖에서도 건너뛰지 않는다
+	static void SetUpdateRate(USkeletalMeshComponent* Mesh, int32 Rate);
+
+	void Register(ACP0Character* Character);
+	void Unregister(ACP0Character* Character);
+
+	bool ShouldCreateSubsystem(UObject* Outer) const override;
+	void Tick(float DeltaTime) override;
+	TStatId GetStatId() const override;
+	bool IsTickable() const override { return true; }
+	ETickableTickType GetTickableTickType() const override;
+	UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+private:
+	void UpdatePressure(float DeltaTime);
+	void UpdateRates();
+
+	TArray<TWeakObjectPtr<ACP0Character>> Characters;
+	FAnimBudgetCounter Counter;
+	float AvgMs = 0.0f;
+	float TimeUntilUpdate = 0.0f;
+	float TimeSincePressureChange = 0.0f;
+	int32 Pressure = 0;
+	int32 NumReduced = 0;
+	float SkippedPerFrame = 0.0f;
+};
@@ -0,0 +1,74 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#pragma once
+
+#include "CP0.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "Ballistics.generated.h"
+
+class AWeapon;
+
+/**
+ * 서버 전용. 비행 중인 모든 탄을 구조체 배열(SoA)로 들고 있으면서 중력과 항력을 4개씩 SIMD로 적분하고,
+ * 이번 틱에 이동한 구간을 비동기 트레이스로 요청해서 다음 틱에 결과를 읽는다. 탄 하나마다 액터를 스폰하지 않는다.
+ */
+UCLASS()
+class CP0_API UBallisticsSubsystem final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr auto MaxLifetime = 5.0f;
+
+	/**
+	 * @param InDrag 이차 항력 계수 (1/cm). 가속도 = -Drag * |v| * v
+	 * @param TimeOffset 이번 프레임의 끝보다 얼마나 이전에 발사되었는지. 첫 적분은 이만큼만 진행
+	 * @param InRewindTime 캐릭터 판정시 지연 보상으로 되감을 시간
+	 */
+	void Launch(AWeapon* Weapon, const FVector& Origin, const FVector& Velocity, float InDrag, float Range,
+	            float TimeOffset, float InRewindTime);
+
+	int32 GetNumRounds() const { return NumRounds; }
+
+	void Tick(float DeltaTime) override;
+	TStatId GetStatId() const override;
+	bool IsTickable() const override { return NumRounds > 0; }
+	ETickableTickType GetTickableTickType() const override;
+	UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+private:
+	// SIMD로 처리되는 값들. 4의 배수 길이로 유지하며 남는 칸은 0으로 채워서 움직이지 않게 한다
+	enum ELane
+	{
+		PosX, PosY, PosZ,
+		PrevX, PrevY, PrevZ,
+		VelX, VelY, VelZ,
+		Drag,
+		StepTime,
+		NumLanes
+	};
+
+	static FCollisionQueryParams MakeQueryParams(const AWeapon* Weapon, const AActor* Instigator);
+
+	void Resolve(float DeltaTime);
+	void Integrate(float DeltaTime, float GravityZ);
+	void RequestTraces(float Now);
+	void RemoveRound(int32 Idx);
+	int32 GetNumPadded() const { return Align(NumRounds, 4); }
+
+	TArray<float, TAlignedHeapAllocator<16>> Lanes[NumLanes];
+
+	TArray<float> RangeLeft;
+	TArray<float> Age;
+	TArray<float> RewindTime;
+	TArray<TWeakObjectPtr<AWeapon>> Weapons;
+	TArray<TWeakObjectPtr<AActor>> Instigators;
+
+	// 지난 틱에 이동한 구간(Prev~Pos)의 지형지물 트레이스. 아직 적분되지 않은 탄은 유효하지 않다
+	TArray<FTraceHandle> Traces;
+	TArray<float> TraceTimes;
+
+	int32 NumRounds = 0;
+};
@@ -3,19 +3,54 @@
 #pragma once
 
 #include "Animation/AnimInstance.h"
+#include "AnimBudget.h"
 #include "CP0.h"
 #include "CP0AnimInstance.generated.h"
 
+class UCP0AnimInstance;
+
 /**
- *
+ * 게임 스레드에서는 캐릭터 상태를 복사만 하고, 계산은 애님 그래프와 같은 작업 스레드에서 한다.
  */
+USTRUCT()
+struct FCP0AnimInstanceProxy : public FBudgetedAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FCP0AnimInstanceProxy() = default;
+
+	explicit FCP0AnimInstanceProxy(UAnimInstance* Instance) : FBudgetedAnimInstanceProxy{Instance}
+	{
+	}
+
+protected:
+	void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	void Update(float DeltaSeconds) override;
+
+private:
+	FVector Velocity = FVector::ZeroVector;
+	FRotator ActorRotation = FRotator::ZeroRotator;
+	FRotator AimRotation = FRotator::ZeroRotator;
+	float MeshPitchOffset = 0.0f;
+	EPosture Posture = EPosture::Stand;
+	bool bHasCharacter = false;
+	bool bIsOnGround = true;
+	bool bIsSprinting = false;
+	bool bIsProneSwitching = false;
+
+	float PrevYaw = 0.0f;
+	float YawCalcLag = 0.0f;
+};
+
 UCLASS()
 class CP0_API UCP0AnimInstance : public UAnimInstance
 {
 	GENERATED_BODY()
 
 private:
-	void NativeUpdateAnimation(float DeltaSeconds) override;
+	friend FCP0AnimInstanceProxy;
+
+	FAnimInstanceProxy* CreateAnimInstanceProxy() override;
 
 	UPROPERTY(EditInstanceOnly, Transient, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	FRotator MeshRotOffset;
@@ -38,8 +73,6 @@ private:
 	UPROPERTY(EditInstanceOnly, Transient, BlueprintReadOnly,
 		meta = (AllowPrivateAccess = true, UIMin = -180, UIMax = 180))
 	float YawSpeed;
-	float PrevYaw;
-	float YawCalcLag;
 
 	UPROPERTY(EditInstanceOnly, Transient, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	EPosture Posture = EPosture::Stand;
@@ -4,11 +4,15 @@
 
 #include "CP0.h"
 #include "GameFramework/Character.h"
+#include "InputCapture.h"
+#include "LagCompensation.h"
+#include "Significance.h"
 #include "CP0Character.generated.h"
 
 class UCP0CharacterMovement;
 class UWeaponComponent;
 class UCameraComponent;
+class UCharacterUpdateSubsystem;
 
 UENUM()
 enum class EInputAction : uint8
@@ -18,6 +22,39 @@ enum class EInputAction : uint8
 	Toggle
 };
 
+/**
+ * 다른 플레이어에게 보내는 조준 방향. 피치는 -90~90도만 쓰므로 15비트, 요는 16비트로 한 번에 보낸다.
+ */
+USTRUCT()
+struct FRemoteViewRotation
+{
+	GENERATED_BODY()
+
+	static FRemoteViewRotation Compress(const FRotator& Rotation);
+	FRotator Decompress() const;
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FRemoteViewRotation& Other) const { return Pitch == Other.Pitch && Yaw == Other.Yaw; }
+	bool operator!=(const FRemoteViewRotation& Other) const { return !(*this == Other); }
+
+	UPROPERTY()
+	uint16 Pitch = 0;
+
+	UPROPERTY()
+	uint16 Yaw = 0;
+};
+
+template <>
+struct TStructOpsTypeTraits<FRemoteViewRotation> : TStructOpsTypeTraitsBase2<FRemoteViewRotation>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
+
 UCLASS()
 class CP0_API ACP0Character : public ACharacter
 {
@@ -29,6 +66,7 @@ public:
 	UWeaponComponent* GetWeaponComp() const { return WeaponComp; }
 	UCameraComponent* GetCamera() const { return Camera; }
 	USkeletalMeshComponent* GetArms() const { return ArmsMesh; }
+	const TArray<FHitbox>& GetHitboxes() const { return Hitboxes; }
 
 	virtual void RecalculateBaseEyeHeight() override
 	{
@@ -44,22 +82,36 @@ public:
 	float GetDefaultEyeHeight(EPosture Posture) const;
 	float GetEyeHeight() const;
 
+	ESignificance GetSignificance() const { return Significance; }
+	void SetSignificance(ESignificance NewSignificance);
+
+	// 캡처된 입력 한 프레임을 실제 입력과 같은 경로로 적용. 다음 틱에 반영된다
+	void ApplyCapturedInput(const FInputCaptureFrame& Frame);
+
 	UFUNCTION(BlueprintImplementableEvent)
 	void OnPostureChanged(EPosture PrevPosture, EPosture NewPosture);
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Tick(float DeltaTime) override;
 	virtual void SetupPlayerInputComponent(UInputComponent* InputComp) override;
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+	virtual void PostNetReceiveRole() override;
+	virtual void PawnClientRestart() override;
+	virtual void UnPossessed() override;
 
 private:
 	friend UCP0CharacterMovement;
+	friend UCharacterUpdateSubsystem;
 
-	void InterpEyeHeight(float DeltaTime);
-	void UpdateLegsTransform() const;
-	void UpdateArmsTransform(float DeltaTime);
+	void UpdateActorTickEnabled();
+	void UpdateLegs();
+	void UpdateInputCapture(float DeltaTime);
+	void UpdateNetUpdateFrequency(float DeltaTime);
+	float FindNearestViewerDistance() const;
+	void StopInputCapture();
 
 	UFUNCTION(Server, Reliable, WithValidation)
 	void ServerInputAction(uint8 Idx, EInputAction Type);
@@ -82,21 +134,39 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	USkeletalMeshComponent* ArmsMesh;
 
-	FTransform ArmsLocalOffset;
-	FRotator PrevAimRot;
-	FRotator AimRotSpeed;
-	
+	UPROPERTY(EditDefaultsOnly, Category = "Hitbox")
+	TArray<FHitbox> Hitboxes;
+
 	UPROPERTY(EditAnywhere, Category = "Camera")
 	float ProneEyeHeight = 35.0f;
 
-	float TargetEyeHeight = 150.0f;
-	float PrevEyeHeight = 150.0f;
-	float EyeHeightAlpha = 1.0f;
-	float EyeHeightBlendTime = 1.0f;
+	// 다리가 자체 애님 그래프 대신 몸 메시의 포즈를 본 이름으로 그대로 가져다 쓴다. 다리 메시에 없는 본은 무시됨
+	UPROPERTY(EditDefaultsOnly, Category = "Legs")
+	bool bLegsFollowBodyPose = true;
 
-	UPROPERTY(Replicated, Transient)
-	uint16 RemoteViewPitch16;
+	// 가만히 있을 때의 초당 네트워크 업데이트 횟수. 움직이는 만큼 NetUpdateFrequency까지 올라간다
+	UPROPERTY(EditDefaultsOnly, Category = "Replication", meta = (UIMin = 0, ClampMin = 0))
+	float IdleNetUpdateFrequency = 4.0f;
+
+	// 이 속도(도/초)로 조준을 돌리면 최대 빈도
+	UPROPERTY(EditDefaultsOnly, Category = "Replication", meta = (UIMin = 0, ClampMin = 0))
+	float FullRateAimSpeed = 90.0f;
+
+	// 가장 가까운 다른 플레이어가 이보다 멀면 활동량을 절반으로 보고 빈도를 정한다
+	UPROPERTY(EditDefaultsOnly, Category = "Replication", meta = (UIMin = 0, ClampMin = 0))
+	float FarViewerDistance = 5000.0f;
+
+	float MaxNetUpdateFrequency = 0.0f;
+	float NearestViewerDistance = 0.0f;
+	float ViewerDistanceAge = 0.0f;
+	FRotator PrevNetAimRot;
+
+	int32 UpdateIndex = INDEX_NONE;
+	ESignificance Significance = ESignificance::High;
+
+	TUniquePtr<FInputCapture> InputCapture;
+	FInputCaptureFrame PendingInput;
 
 	UPROPERTY(Replicated, Transient)
-	uint16 RemoteViewYaw16;
+	FRemoteViewRotation RemoteViewRotation;
 };
@@ -7,6 +7,8 @@
 #include "CP0CharacterMovement.generated.h"
 
 class ACP0Character;
+class UCP0PostureData;
+struct FPostureTable;
 
 enum ESetPostureCheckLevel
 {
@@ -16,19 +18,106 @@ enum ESetPostureCheckLevel
 	SPCL_CheckAll,
 };
 
-USTRUCT()
-struct FCP0MovementCorrectionData
+/**
+ * 자세, 달리기, 천천히 걷기 입력을 압축 플래그에 담아 이동과 함께 예측/재생한다.
+ * Custom_0/1: 원하는 자세, Custom_2: 달리기, Custom_3: 천천히 걷기
+ */
+class FSavedMove_CP0 : public FSavedMove_Character
 {
-	GENERATED_BODY()
+	using Super = FSavedMove_Character;
 
-	UPROPERTY()
-	EPosture Posture;
+public:
+	FSavedMove_CP0() : bWantsToSprint{false}, bWalkingSlow{false}
+	{
+	}
 
-	UPROPERTY()
-	EPosture PrevPosture;
+	void Clear() override;
+	uint8 GetCompressedFlags() const override;
+	bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel,
+	                FNetworkPredictionData_Client_Character& ClientData) override;
 
-	UPROPERTY()
-	uint8 bSprinting : 1;
+	EPosture WantedPosture = EPosture::Stand;
+	uint8 bWantsToSprint : 1;
+	uint8 bWalkingSlow : 1;
+};
+
+class FNetworkPredictionData_Client_CP0 : public FNetworkPredictionData_Client_Character
+{
+public:
+	explicit FNetworkPredictionData_Client_CP0(const UCharacterMovementComponent& ClientMovement);
+	FSavedMovePtr AllocateNewMove() override;
+};
+
+// 보정이 필요할 때만 위치와 함께 서버의 자세 상태를 보낸다
+struct FCP0MoveResponseDataContainer : FCharacterMoveResponseDataContainer
+{
+	using Super = FCharacterMoveResponseDataContainer;
+
+	void ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement,
+	                            const FClientAdjustment& PendingAdjustment) override;
+	bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap) override;
+
+	EPosture Posture = EPosture::Stand;
+	float PostureSwitchTimeLeft = 0.0f;
+	bool bSprinting = false;
+};
+
+/**
+ * 함수별 누적 시간. MovementReplay 커맨드렛에서 켜서 쓰며, 꺼져 있을 때는 분기 하나만 든다. 게임 스레드 전용
+ */
+struct CP0_API FMovementTimers
+{
+	enum EId
+	{
+		TickComponent,
+		StateBeforeMovement,
+		TrySetPosture,
+		PronePush,
+		PronePitch,
+		Num
+	};
+
+	static const TCHAR* const Names[Num];
+	static bool bEnabled;
+	static uint64 Cycles[Num];
+	static uint32 Calls[Num];
+
+	static void Reset();
+
+	struct FScope
+	{
+		explicit FScope(EId InId)
+			: Id{InId}, Start{bEnabled ? FPlatformTime::Cycles64() : 0}
+		{
+		}
+
+		~FScope()
+		{
+			if (Start == 0)
+				return;
+
+			Cycles[Id] += FPlatformTime::Cycles64() - Start;
+			++Calls[Id];
+		}
+
+	private:
+		EId Id;
+		uint64 Start;
+	};
+};
+
+/**
+ * 엎드린 상태에서 매 틱 필요한 트레이스들. 이번 프레임에 비동기로 요청하고 다음 프레임에 결과를 읽는다.
+ * 월드의 비동기 트레이스 버퍼가 모든 캐릭터의 요청을 모아서 프레임의 나머지 작업과 병렬로 처리한다.
+ * 정적 지형은 가능하면 지형 캐시에서 얻고, 이 경우 트레이스는 움직이는 물체만 검사한다.
+ */
+struct FProneQuery
+{
+	FTraceHandle Floor[2];
+	FTraceHandle Push[2];
+	FVector StaticFloor[2];
+	bool bStaticFloor[2] = {};
 };
 
 /**
@@ -47,18 +136,22 @@ public:
 	float GetMaxAcceleration() const override;
 	bool CanAttemptJump() const override;
 
-	bool IsInSprintMode() const { return bSprinting; }
+	bool IsInSprintMode() const { return bWantsToSprint; }
 	bool IsActuallySprinting() const;
 	bool CanSprint(bool bIgnorePosture = false) const;
-	bool TryStartSprint();
-	void StopSprint();
+	void RequestSprint(bool bWants) { bWantsToSprint = bWants; }
 	float GetLastActualSprintTime() const { return LastActualSprintTime; }
 
 	bool TrySetPosture(EPosture New, ESetPostureCheckLevel CheckLevel = SPCL_CheckAll);
+
+	// 다음 이동에서 자세를 바꾼다. 전환 중이면 끝날 때까지 미뤄지고, 공간이 없는 등으로 막히면 요청이 취소된다
+	void RequestPosture(EPosture New) { WantedPosture = New; }
 	EPosture GetPosture() const { return Posture; }
+	EPosture GetWantedPosture() const { return WantedPosture; }
 	bool IsPostureSwitching() const;
+	float GetPostureSwitchTimeLeft() const { return PostureSwitchTimeLeft; }
 	bool IsProneSwitching() const;
-	static float GetPostureSwitchTime(EPosture Prev, EPosture New);
+	float GetPostureSwitchTime(EPosture Prev, EPosture New) const;
 	float GetDefaultHalfHeight(EPosture P) const;
 
 	bool IsWalkingSlow() const { return bWalkingSlow; }
@@ -66,35 +159,51 @@ public:
 	bool TryStartWalkingSlow();
 	void StopWalkingSlow() { bWalkingSlow = false; }
 
-	float CalcFloorPitch() const;
+	FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
 	float GetMeshPitchOffset() const { return MeshPitchOffset; }
 
+	// 끄면 엎드린 자세의 바닥 경사를 더 이상 검사하지 않고 마지막 값을 유지. 켜져 있으면 Interval마다 검사한다
+	void SetCosmeticTraces(bool bEnabled, float Interval);
+
 protected:
+	void PostInitProperties() override;
+	void PostLoad() override;
+	void InitializeComponent() override;
 	void BeginPlay() override;
 	void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
 	void ProcessLanded(const FHitResult& Hit, float remainingTime, int32 Iterations) override;
 	bool DoJump(bool bReplayingMoves) override;
+	void UpdateFromCompressedFlags(uint8 Flags) override;
+	void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
+	void ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse) override;
+	bool ClientUpdatePositionAfterServerUpdate() override;
 
 private:
-	float CurTime() const;
+	friend FCP0MoveResponseDataContainer;
+
 	const UCP0CharacterMovement* GetDefaultSelf() const;
+	const FPostureTable& GetPostureTable() const;
+	void BuildFallbackPostureData();
 
+	bool TryStartSprint();
+	void StopSprint();
 	void ProcessSprint();
 	void ProcessSlowWalk();
 	void ProcessForceTurn() const;
 	void ProcessPronePush();
 	void ProcessPronePitch(float DeltaTime);
+	void RequestPronePushTraces();
+	void RequestFloorTraces();
+	bool ReadAsyncTrace(FTraceHandle& Handle, FHitResult& OutHit, bool& bOutBlocked) const;
+	static float CalcFloorPitch(const FVector& Front, const FVector& Rear);
 	void UpdateRotationRate();
 	void UpdateViewPitchLimit(float DeltaTime) const;
-	void CorrectClientState();
 
 	void ShrinkPerchRadius();
 
-	UFUNCTION(Client, Unreliable)
-	void Client_CorrectState(FCP0MovementCorrectionData Data);
-
 	UFUNCTION()
 	void OnRep_Posture(EPosture Prev);
 
@@ -102,23 +211,41 @@ private:
 	void SetSprinting(bool bNewValue);
 
 	FVector ForceInput;
-	float NextPostureSwitch;
+	float PostureSwitchTimeLeft;
 	float MeshPitchOffset;
+	FProneQuery ProneQuery;
+	bool bCosmeticTraces = true;
+	float CosmeticTraceInterval = 0.0f;
+	float TimeUntilCosmeticTrace = 0.0f;
 	float LastActualSprintTime;
 
-	float Posture_LastModifiedTime;
-	float Sprinting_LastModifiedTime;
-	float NextCorrectionTime;
+	FCP0MoveResponseDataContainer MoveResponseData;
 
 	UPROPERTY(EditAnywhere)
 	TEnumAsByte<ECollisionChannel> PushTraceChannel;
 
+	// 지정하지 않으면 이 컴포넌트의 기본값으로 만든다
+	UPROPERTY(EditDefaultsOnly, Category = "Posture")
+	UCP0PostureData* PostureData;
+
+	// 템플릿(클래스 기본 객체의 컴포넌트)에서만 만든다. 인스턴스는 템플릿의 것을 쓴다
+	UPROPERTY(Transient)
+	UCP0PostureData* FallbackPostureData;
+
+	// 클래스 기본 객체의 데이터를 가리키므로 모든 인스턴스가 같은 표를 공유한다
+	mutable const FPostureTable* PostureTable = nullptr;
+
+	// 자세를 바꿀 때마다 클래스 기본 객체를 다시 찾지 않도록
+	mutable const UCP0CharacterMovement* DefaultSelf = nullptr;
+
 	UPROPERTY(ReplicatedUsing = OnRep_Posture, Transient, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	EPosture Posture = EPosture::Stand;
 	EPosture PrevPosture = EPosture::Stand;
+	EPosture WantedPosture = EPosture::Stand;
 
 	UPROPERTY(Replicated, Transient, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	uint8 bSprinting : 1;
+	uint8 bWantsToSprint : 1;
 	uint8 bWalkingSlow : 1;
 };
 
@@ -0,0 +1,108 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#pragma once
+
+#include "CP0.h"
+#include "Engine/DataAsset.h"
+#include "CP0PostureData.generated.h"
+
+/**
+ * 이동 컴포넌트가 매 틱 읽는 자세별 값들을 EPosture로 바로 인덱싱할 수 있게 펼쳐둔 표
+ */
+struct alignas(PLATFORM_CACHE_LINE_SIZE) FPostureTable
+{
+	static constexpr auto Num = 3;
+
+	// [이전 자세][새 자세]
+	float SwitchTime[Num][Num];
+	float MaxSpeed[Num];
+	float MaxAcceleration[Num];
+	float HalfHeight[Num];
+	float RotationRate[Num];
+	float SprintSpeed;
+
+	float GetSwitchTime(EPosture Prev, EPosture New) const
+	{
+		return SwitchTime[static_cast<uint8>(Prev)][static_cast<uint8>(New)];
+	}
+
+	float GetMaxSpeed(EPosture P) const { return MaxSpeed[static_cast<uint8>(P)]; }
+	float GetMaxAcceleration(EPosture P) const { return MaxAcceleration[static_cast<uint8>(P)]; }
+	float GetHalfHeight(EPosture P) const { return HalfHeight[static_cast<uint8>(P)]; }
+	float GetRotationRate(EPosture P) const { return RotationRate[static_cast<uint8>(P)]; }
+};
+
+USTRUCT(BlueprintType)
+struct FPostureTuning
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (UIMin = 0, ClampMin = 0))
+	float MaxSpeed = 300.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (UIMin = 0, ClampMin = 0))
+	float MaxAcceleration = 1024.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (UIMin = 0, ClampMin = 0))
+	float HalfHeight = 88.0f;
+
+	// 초당 회전 각도 (Yaw)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (UIMin = 0, ClampMin = 0))
+	float RotationRate = 90.0f;
+};
+
+/**
+ * 자세별 이동 수치. 캐릭터 이동 컴포넌트의 PostureData에 지정하며, 지정하지 않으면 컴포넌트 기본값으로 만들어진다.
+ * 로드될 때와 에디터에서 수정될 때마다 FPostureTable로 다시 만들어지므로 플레이 중에도 바로 반영된다.
+ */
+UCLASS(BlueprintType)
+class CP0_API UCP0PostureData final : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UCP0PostureData();
+
+	const FPostureTable& GetTable() const { return Table; }
+	void Compile();
+
+	void PostInitProperties() override;
+	void PostLoad() override;
+
+#if WITH_EDITOR
+	void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Posture")
+	FPostureTuning Stand;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Posture")
+	FPostureTuning Crouch;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Posture")
+	FPostureTuning Prone;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Posture", meta = (UIMin = 0, ClampMin = 0))
+	float SprintSpeed = 500.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Switch Time", meta = (UIMin = 0, ClampMin = 0))
+	float StandToCrouch = 0.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Switch Time", meta = (UIMin = 0, ClampMin = 0))
+	float StandToProne = 1.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Switch Time", meta = (UIMin = 0, ClampMin = 0))
+	float CrouchToStand = 0.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Switch Time", meta = (UIMin = 0, ClampMin = 0))
+	float CrouchToProne = 1.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Switch Time", meta = (UIMin = 0, ClampMin = 0))
+	float ProneToStand = 1.8f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Switch Time", meta = (UIMin = 0, ClampMin = 0))
+	float ProneToCrouch = 1.2f;
+
+private:
+	FPostureTable Table;
+};
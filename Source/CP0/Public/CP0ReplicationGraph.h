@@ -0,0 +1,126 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#pragma once
+
+#include "CP0.h"
+#include "ReplicationGraph.h"
+#include "CP0ReplicationGraph.generated.h"
+
+class AWeapon;
+
+enum class ECP0RepNodeMapping : uint8
+{
+	// 다른 노드에서 직접 모으거나(컨트롤러, 플레이어 스테이트) 소유자를 따라가는(무기) 액터
+	NotRouted,
+
+	// 게임 스테이트 등 모든 연결에 항상 보낸다
+	RelevantAllConnections,
+
+	// bOnlyRelevantToOwner인 액터. 소유자의 연결에만 매 프레임 보낸다
+	RelevantOwnerConnection,
+
+	// 그리드에 넣고 움직이지 않는다고 본다
+	Spatialize_Static,
+
+	// 그리드에 넣고 매 프레임 셀을 다시 계산한다
+	Spatialize_Dynamic,
+
+	// 깨어 있는 동안만 Dynamic으로 취급한다
+	Spatialize_Dormancy
+};
+
+/**
+ * CP0 서버의 리플리케이션 그래프. 연결마다 모든 액터의 관련성을 검사하는 대신 캐릭터 등 공간에 있는 액터는 2D 그리드에
+ * 넣고, 각 연결은 자기 시점이 있는 셀의 액터만 모은다. 무기는 라우팅하지 않고 소유자 캐릭터의 종속 액터로 붙여서
+ * 캐릭터가 보내질 때만 함께 보낸다. 활성화는 DefaultEngine.ini의 ReplicationDriverClassName 참고.
+ */
+UCLASS(Transient)
+class CP0_API UCP0ReplicationGraph final : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr auto CellSize = 10000.0f;
+
+	// 그리드 원점. 맵 전체가 양수 셀에 들어가도록 충분히 음수로 잡는다
+	static constexpr auto SpatialBias = -150000.0f;
+
+	// 무기의 소유자가 바뀌면 이전 소유자에서 떼고 새 소유자에 종속시킨다
+	static void OnWeaponOwnerChanged(AWeapon* Weapon, AActor* OldOwner);
+
+	// 그래프는 AActor::NetUpdateFrequency를 보지 않으므로 액터별로 바꾼 빈도를 직접 넘겨준다
+	static void SetNetUpdateFrequency(AActor* Actor, float Frequency);
+
+	void InitGlobalActorClassSettings() override;
+	void InitGlobalGraphNodes() override;
+	void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo,
+	                                 FGlobalActorReplicationInfo& GlobalInfo) override;
+	void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+private:
+	static UCP0ReplicationGraph* Find(const AActor* Actor);
+
+	ECP0RepNodeMapping GetMappingPolicy(UClass* Class);
+	uint32 GetReplicationPeriod(float Frequency) const;
+
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+	// 소유자가 바뀔 수 있으므로 연결별로 나눠두지 않고, 연결마다 모을 때 소유 연결을 확인한다. 수가 적다
+	TArray<AActor*> OwnerOnlyActors;
+
+	TClassMap<ECP0RepNodeMapping> ClassRepNodePolicies;
+};
+
+/**
+ * 연결마다 자기 컨트롤러, 시점 대상, 폰, 플레이어 스테이트와 이 연결이 소유한 bOnlyRelevantToOwner 액터를 매 프레임 모은다.
+ */
+UCLASS()
+class CP0_API UCP0ReplicationGraphNode_AlwaysRelevant_ForConnection final
+	: public UReplicationGraphNode_AlwaysRelevant_ForConnection
+{
+	GENERATED_BODY()
+
+public:
+	void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	const TArray<AActor*>* OwnerOnlyActors = nullptr;
+};
+
+/**
+ * 플레이어 스테이트를 작은 묶음으로 나눠서 연결마다 프레임당 한 묶음씩만 보낸다. 연결마다 시작 묶음을 다르게 해서
+ * 프레임당 서버가 직렬화하는 양을 고르게 한다. 플레이어 수가 늘면 묶음 수가 늘어날 뿐 프레임당 비용은 그대로다.
+ */
+UCLASS()
+class CP0_API UCP0ReplicationGraphNode_PlayerStateFrequencyLimiter final : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	UCP0ReplicationGraphNode_PlayerStateFrequencyLimiter();
+
+	void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override
+	{
+	}
+
+	bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override
+	{
+		return false;
+	}
+
+	void NotifyResetAllNetworkActors() override
+	{
+	}
+
+	void PrepareForReplication() override;
+	void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	static constexpr auto ActorsPerFrame = 2;
+
+private:
+	TArray<FActorRepListRefView> ReplicationActorLists;
+};
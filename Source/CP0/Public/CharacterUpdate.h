@@ -0,0 +1,81 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#pragma once
+
+#include "CP0.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "CharacterUpdate.generated.h"
+
+class ACP0Character;
+
+/**
+ * 모든 캐릭터의 매 프레임 꾸밈용 갱신(눈높이 블렌드, 팔 흔들림, 다리/팔/카메라 위치)을 한 루프에서 처리한다.
+ * 갱신에 필요한 상태는 캐릭터가 아니라 여기의 연속된 배열에 두고, 컴포넌트 트랜스폼 쓰기는 계산이 모두 끝난 뒤
+ * 한꺼번에 한다. 틱 그룹이 모두 끝난 뒤에 돌기 때문에 이동이 반영된 위치를 쓴다.
+ */
+UCLASS()
+class CP0_API UCharacterUpdateSubsystem final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	void Register(ACP0Character* Character);
+	void Unregister(ACP0Character* Character);
+
+	// 등록되지 않았거나 블렌드 시간이 0이면 false. 호출한 쪽에서 바로 적용해야 한다
+	bool BlendEyeHeight(const ACP0Character* Character, float NewEyeHeight, float BlendTime);
+
+	// 중요도에 따라 갱신 간격과 팔 갱신 여부를 정한다
+	void SetUpdateRate(const ACP0Character* Character, float Interval, bool bArms);
+
+	// 다리는 로컬 플레이어만
+	void SetLegsEnabled(const ACP0Character* Character, bool bLegs);
+
+	void Tick(float DeltaTime) override;
+	TStatId GetStatId() const override;
+	bool IsTickable() const override { return Characters.Num() > 0; }
+	ETickableTickType GetTickableTickType() const override;
+	UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+private:
+	struct FState
+	{
+		FTransform ArmsBase;
+		FQuat ArmsLocalRotation = FQuat::Identity;
+		FRotator PrevAimRot = FRotator::ZeroRotator;
+		FRotator AimRotSpeed = FRotator::ZeroRotator;
+
+		float TargetEyeHeight = 0.0f;
+		float PrevEyeHeight = 0.0f;
+		float EyeHeightAlpha = 1.0f;
+		float EyeHeightBlendTime = 1.0f;
+
+		float LegsOffset = 0.0f;
+		float Interval = 0.0f;
+		float TimeUntilUpdate = 0.0f;
+		float PendingDelta = 0.0f;
+
+		bool bLegs = false;
+		bool bArms = true;
+		bool bCamera = true;
+	};
+
+	struct FWrite
+	{
+		ACP0Character* Character;
+		FTransform Arms;
+		FVector Legs;
+		FVector ViewLocation;
+		bool bLegs;
+		bool bArms;
+		bool bCamera;
+	};
+
+	static void Update(FState& State, ACP0Character* Character, float DeltaTime, FWrite& Write);
+	static void Apply(const FWrite& Write);
+
+	TArray<TWeakObjectPtr<ACP0Character>> Characters;
+	TArray<FState> States;
+	TArray<FWrite> Writes;
+};
@@ -0,0 +1,65 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#pragma once
+
+#include "CP0.h"
+#include "Templates/Atomic.h"
+
+CP0_API DECLARE_LOG_CATEGORY_EXTERN(LogHitAudit, Log, All);
+
+enum class EHitAuditEvent : uint8
+{
+	BeginFiring,
+	Shot,
+	Hit,
+	Correction
+};
+
+struct FHitAuditHeader
+{
+	static constexpr uint32 MagicValue = 0x41305043; // "CP0A"
+	static constexpr uint32 CurrentVersion = 1;
+
+	uint32 Magic = MagicValue;
+	uint32 Version = CurrentVersion;
+	uint32 RecordSize = 0;
+	uint32 Reserved = 0;
+};
+
+struct FHitAuditRecord
+{
+	float Time = 0.0f;
+	int32 ShooterId = INDEX_NONE;
+	int32 TargetId = INDEX_NONE;
+	FVector ShooterPos = FVector::ZeroVector;
+	FVector TargetPos = FVector::ZeroVector;
+	uint16 Seed = 0;
+	EHitAuditEvent Event = EHitAuditEvent::Shot;
+	uint8 ShotIndex = 0;
+	uint8 Clip = 0;
+	uint8 State = 0;
+	uint8 Reserved[2] = {};
+};
+
+static_assert(sizeof(FHitAuditRecord) == 44, "Hit audit file format changed");
+
+/**
+ * 명중 판정 감사 로그. CP0.HitAudit 1로 켜면 Saved/HitAudit에 이진 파일로 기록된다.
+ * 기록은 락 없이 스레드별 링 버퍼에 쌓이고, 별도 스레드가 주기적으로 모든 링을 비워서 파일에 쓴다.
+ * 읽기는 HitAudit 커맨드렛 참고.
+ */
+class CP0_API FHitAudit
+{
+public:
+	static bool IsEnabled() { return bEnabled; }
+	static void Record(const FHitAuditRecord& Rec);
+
+	static void Start();
+	static void Stop();
+
+	// 다음 주기를 기다리지 않고 쓰기 스레드가 바로 링을 비우게 한다
+	static void Flush();
+
+private:
+	static TAtomic<bool> bEnabled;
+};
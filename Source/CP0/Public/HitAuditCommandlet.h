@@ -0,0 +1,22 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#pragma once
+
+#include "CP0.h"
+#include "Commandlets/Commandlet.h"
+#include "HitAuditCommandlet.generated.h"
+
+/**
+ * 명중 판정 감사 로그를 읽어서 플레이어별로 집계한다.
+ * 예: UE4Editor-Cmd CP0.uproject -run=HitAudit [-File=<경로>] [-Shooter=<PlayerId>]
+ * 파일을 지정하지 않으면 Saved/HitAudit의 가장 최근 파일을 읽고, Shooter를 지정하면 해당 플레이어의 기록을 모두 출력한다.
+ */
+UCLASS()
+class CP0_API UHitAuditCommandlet final : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UHitAuditCommandlet();
+	int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,55 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#pragma once
+
+#include "CP0.h"
+
+struct FInputCaptureHeader
+{
+	static constexpr uint32 MagicValue = 0x49305043; // "CP0I"
+	static constexpr uint32 CurrentVersion = 1;
+
+	uint32 Magic = MagicValue;
+	uint32 Version = CurrentVersion;
+	uint32 FrameSize = 0;
+	uint32 NumFrames = 0;
+	FVector StartLocation = FVector::ZeroVector;
+	FRotator StartRotation = FRotator::ZeroRotator;
+	EPosture StartPosture = EPosture::Stand;
+	uint8 Reserved[3] = {};
+};
+
+// 로컬 캐릭터의 틱 한 번 동안 들어온 입력. 회전은 누적 입력 대신 결과 값을 기록해서 컨트롤러 없이도 재생할 수 있다
+struct FInputCaptureFrame
+{
+	static constexpr auto MaxActions = 4;
+
+	float DeltaTime = 0.0f;
+	float Forward = 0.0f;
+	float Right = 0.0f;
+	float Pitch = 0.0f;
+	float Yaw = 0.0f;
+	uint8 NumActions = 0;
+	uint8 bJump = 0;
+	uint8 ActionIdx[MaxActions] = {};
+	uint8 ActionType[MaxActions] = {};
+	uint8 Reserved[2] = {};
+};
+
+static_assert(sizeof(FInputCaptureFrame) == 32, "Input capture file format changed");
+
+/**
+ * 입력 캡처. CP0.CaptureInput 1로 켜면 로컬 캐릭터의 입력을 기록하고, 끄면 Saved/InputCapture에 저장한다.
+ * 재생은 MovementReplay 커맨드렛 참고.
+ */
+struct CP0_API FInputCapture
+{
+	static bool IsEnabled();
+	static FString MakeFilename();
+
+	bool Save(const FString& Filename) const;
+	bool Load(const FString& Filename);
+
+	FInputCaptureHeader Header;
+	TArray<FInputCaptureFrame> Frames;
+};
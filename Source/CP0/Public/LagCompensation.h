@@ -0,0 +1,89 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#pragma once
+
+#include "CP0.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "LagCompensation.generated.h"
+
+class ACP0Character;
+
+USTRUCT()
+struct FHitbox
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere)
+	FName Bone;
+
+	UPROPERTY(EditAnywhere, meta = (UIMin = 0, ClampMin = 0))
+	float Radius = 10.0f;
+
+	// 본의 X축 방향으로 늘어나는 캡슐의 절반 길이. 0이면 구
+	UPROPERTY(EditAnywhere, meta = (UIMin = 0, ClampMin = 0))
+	float HalfLength = 0.0f;
+};
+
+/**
+ * 서버 전용. 모든 캐릭터의 히트박스 위치를 고정 크기 링 버퍼에 기록해두고,
+ * 사격자가 보고 있던 시점으로 되감아 판정한다. 등록/해제 외에는 메모리 할당을 하지 않는다.
+ */
+UCLASS()
+class CP0_API ULagCompensationSubsystem final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr auto MaxHitboxes = 16;
+	static constexpr auto HistorySize = 32;
+	static constexpr auto MinRecordInterval = 1.0f / 60.0f;
+	static constexpr auto MaxRewindTime = 0.5f;
+
+	void Register(ACP0Character* Character);
+	void Unregister(ACP0Character* Character);
+
+	// Time 시점의 히트박스에 대해 Start~End 선분을 검사. 가장 가까운 캐릭터 히트를 반환
+	bool Trace(const FVector& Start, const FVector& End, float Time, const AActor* Ignore, FHitResult& OutHit) const;
+
+	// 클라이언트 전용. 현재 화면에 보이는 다른 캐릭터들의 서버 기준 시각 추정값
+	static float GetClientViewTime(const APawn* Viewer);
+
+	void Tick(float DeltaTime) override;
+	TStatId GetStatId() const override;
+	bool IsTickable() const override { return Histories.Num() > 0; }
+	ETickableTickType GetTickableTickType() const override;
+	UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+private:
+	struct FFrame
+	{
+		float Time;
+		float BoundRadius;
+		FVector BoundCenter;
+		FVector Start[MaxHitboxes];
+		FVector End[MaxHitboxes];
+	};
+
+	struct FHistory
+	{
+		TWeakObjectPtr<ACP0Character> Character;
+		int32 NumHitboxes = 0;
+		int32 BoneIndices[MaxHitboxes];
+		FName Bones[MaxHitboxes];
+		float HalfLengths[MaxHitboxes];
+		float Radii[MaxHitboxes];
+		float MaxRadius = 0.0f;
+
+		int32 Head = 0;
+		int32 NumFrames = 0;
+		FFrame Frames[HistorySize];
+	};
+
+	static void Record(FHistory& History, float Now);
+	static bool TraceHistory(const FHistory& History, const FVector& Start, const FVector& Dir, float Length,
+	                         float Time, float& OutDist, int32& OutHitbox, FVector& OutNormal);
+
+	TArray<FHistory> Histories;
+	float LastRecordTime = -1.0f;
+};
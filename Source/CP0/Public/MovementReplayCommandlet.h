@@ -0,0 +1,23 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#pragma once
+
+#include "CP0.h"
+#include "Commandlets/Commandlet.h"
+#include "MovementReplayCommandlet.generated.h"
+
+/**
+ * 캡처한 입력을 맵에 스폰한 여러 캐릭터에 그대로 먹여서 이동을 재생한다. 함수별 시간과 최종 상태 해시를 출력한다.
+ * 예: UE4Editor-Cmd CP0.uproject -run=MovementReplay -Input=Saved/InputCapture/Input.bin -Map=/Game/Maps/Dev
+ *     -Character=/Game/Blueprints/BP_Character.BP_Character_C -Characters=64 -Runs=2 -nullrhi
+ * 매번 맵을 새로 불러와서 돌리며, 실행마다 해시가 다르면 1을 반환한다.
+ */
+UCLASS()
+class CP0_API UMovementReplayCommandlet final : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMovementReplayCommandlet();
+	int32 Main(const FString& Params) override;
+};
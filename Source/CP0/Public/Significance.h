@@ -0,0 +1,64 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#pragma once
+
+#include "CP0.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Significance.generated.h"
+
+class ACP0Character;
+
+// 낮을수록 중요. 단계가 내려갈수록 틱 빈도를 줄이고 꾸밈용 작업을 끈다
+enum class ESignificance : uint8
+{
+	High,
+	Medium,
+	Low,
+	Hidden,
+	Num
+};
+
+/**
+ * 클라이언트 전용. 다른 플레이어의 캐릭터(시뮬레이티드 프록시)를 거리, 시야각, 최근 렌더링 여부로 순위를 매겨
+ * 단계를 나눈다. 높은 단계의 수가 정해져 있어서 플레이어 수가 늘어도 비용이 그만큼 늘지 않는다.
+ */
+UCLASS()
+class CP0_API USignificanceSubsystem final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr auto UpdateInterval = 0.2f;
+	static constexpr auto MaxHigh = 6;
+	static constexpr auto MaxMedium = 16;
+
+	// 이보다 가까우면 보이지 않아도 순위에 든다 (발소리, 벽 너머 등)
+	static constexpr auto NearDistance = 1500.0f;
+
+	// 이보다 멀면 순위와 관계없이 Low 이하
+	static constexpr auto FarDistance = 10000.0f;
+
+	void Register(ACP0Character* Character);
+	void Unregister(ACP0Character* Character);
+
+	void Tick(float DeltaTime) override;
+	TStatId GetStatId() const override;
+	bool IsTickable() const override { return Characters.Num() > 0; }
+	ETickableTickType GetTickableTickType() const override;
+	UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+private:
+	struct FRanked
+	{
+		ACP0Character* Character;
+		float Score;
+		float Distance;
+	};
+
+	void Update();
+
+	TArray<TWeakObjectPtr<ACP0Character>> Characters;
+	TArray<FRanked> Ranked;
+	float TimeUntilUpdate = 0.0f;
+};
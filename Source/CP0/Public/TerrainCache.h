@@ -0,0 +1,109 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#pragma once
+
+#include "CP0.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "WorldCollision.h"
+#include "TerrainCache.generated.h"
+
+struct FTerrainTileKey
+{
+	int32 X, Y, Band;
+	TEnumAsByte<ECollisionChannel> Channel;
+
+	bool operator==(const FTerrainTileKey& Other) const
+	{
+		return X == Other.X && Y == Other.Y && Band == Other.Band && Channel == Other.Channel;
+	}
+
+	friend uint32 GetTypeHash(const FTerrainTileKey& Key)
+	{
+		return HashCombine(HashCombine(GetTypeHash(Key.X), GetTypeHash(Key.Y)),
+		                   HashCombine(GetTypeHash(Key.Band), GetTypeHash(Key.Channel.GetValue())));
+	}
+};
+
+struct FTerrainTile
+{
+	static constexpr auto Res = 32;
+
+	// 격자점의 위에서 내려다 본 정적 지형 높이. 아무것도 없으면 Lowest
+	float Heights[(Res + 1) * (Res + 1)];
+
+	// 칸의 네 격자점 중 가장 높은 곳. 이 아래로 지나가는 수평 검사는 정적 지형에 막히지 않는다
+	float Tops[Res * Res];
+
+	// 턱이나 벽이 걸쳐 있어서 보간한 높이를 믿을 수 없는 칸. 행마다 비트 하나씩
+	uint32 Steep[Res];
+};
+
+/**
+ * 정적 지형의 높이를 격자로 미리 구워두고 보간해서 돌려준다. 엎드린 캐릭터의 바닥 경사와 밀어내기 검사에서
+ * 매 틱 정적 지형을 트레이스하지 않고, 움직이는 물체만 실시간으로 검사하도록 한다.
+ * 타일은 처음 요청될 때 구울 목록에 올라가고, 틱마다 몇 개씩 격자점 트레이스를 비동기로 요청해서 다음 틱에 완성한다.
+ * 그 전까지는 실패를 반환하므로 원래대로 트레이스하면 된다.
+ * 격자 간격보다 얇은 물체(기둥 등)는 놓칠 수 있다.
+ */
+UCLASS()
+class CP0_API UTerrainCacheSubsystem final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr auto CellSize = 25.0f;
+	static constexpr auto TileSize = CellSize * FTerrainTile::Res;
+
+	// 높이 방향으로 이만큼씩 잘라서 따로 굽는다. 위층 바닥이나 천장을 바닥으로 착각하지 않도록
+	static constexpr auto BandHeight = 100.0f;
+
+	// 이웃 격자점의 높이 차가 이보다 크면 턱으로 본다
+	static constexpr auto MaxStepHeight = 20.0f;
+
+	// 틱마다 굽기 시작하는 타일 수. 타일 하나에 (Res + 1)^2개의 트레이스를 요청한다
+	static constexpr auto MaxBakesPerTick = 1;
+
+	/**
+	 * Location 바로 아래 정적 지형의 높이
+	 * @return 아직 굽지 않았거나, 턱 근처이거나, Location보다 위에 지형이 있으면 false
+	 */
+	bool SampleHeight(const FVector& Location, ECollisionChannel Channel, float& OutZ);
+
+	/**
+	 * Start에서 End까지 폭 Radius의 수평 검사가 정적 지형에 막히지 않는지
+	 * @return 확실히 비어 있을 때만 true
+	 */
+	bool IsClear(const FVector& Start, const FVector& End, float Radius, ECollisionChannel Channel);
+
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+
+	void Tick(float DeltaTime) override;
+	TStatId GetStatId() const override;
+	bool IsTickable() const override { return BakeQueue.Num() > 0 || Baking.Num() > 0; }
+	ETickableTickType GetTickableTickType() const override;
+	UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+
+private:
+	// 격자점 트레이스를 요청했고 다음 틱에 결과를 읽을 타일
+	struct FBakingTile
+	{
+		FTerrainTileKey Key;
+		TArray<FTraceHandle> Traces;
+	};
+
+	// 구워진 타일이 없으면 구울 목록에 올리고 nullptr
+	const FTerrainTile* FindTile(const FTerrainTileKey& Key);
+	void RequestBake(const FTerrainTileKey& Key, FBakingTile& Baking) const;
+	void FinishBake(const FBakingTile& Baking, FTerrainTile& Tile) const;
+	void OnLevelChanged(ULevel* Level, UWorld* InWorld);
+
+	// 값이 nullptr이면 구울 목록에 있거나 굽는 중인 타일
+	TMap<FTerrainTileKey, TUniquePtr<FTerrainTile>> Tiles;
+	TArray<FTerrainTileKey> BakeQueue;
+	TArray<FBakingTile> Baking;
+
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+};
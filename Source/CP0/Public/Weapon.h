@@ -3,6 +3,8 @@
 #pragma once
 
 #include "CP0.h"
+#include "HitAudit.h"
+#include "WeaponSim.h"
 #include "GameFramework/Actor.h"
 #include "Weapon.generated.h"
 
@@ -24,6 +26,8 @@ struct FClientWeaponCorrectionData
 {
 	GENERATED_BODY()
 
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
 	UPROPERTY()
 	EWeaponFireMode FireMode;
 
@@ -31,11 +35,22 @@ struct FClientWeaponCorrectionData
 	uint8 bAiming : 1;
 };
 
+template <>
+struct TStructOpsTypeTraits<FClientWeaponCorrectionData> : TStructOpsTypeTraitsBase2<FClientWeaponCorrectionData>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
 USTRUCT()
 struct FMulticastWeaponCorrectionData
 {
 	GENERATED_BODY()
 
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
 	UPROPERTY()
 	uint8 Clip;
 
@@ -43,15 +58,90 @@ struct FMulticastWeaponCorrectionData
 	EWeaponState State;
 };
 
+template <>
+struct TStructOpsTypeTraits<FMulticastWeaponCorrectionData> : TStructOpsTypeTraitsBase2<FMulticastWeaponCorrectionData>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/**
+ * 방아쇠 상태를 비트 단위로 압축한 기록. 시뮬레이티드 프록시는 이것만 받아서 사격을 재현한다.
+ */
+USTRUCT()
+struct FWeaponFireRecord
+{
+	GENERATED_BODY()
+
+	FWeaponFireRecord() : bFiring{false}
+	{
+	}
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	UPROPERTY()
+	uint16 Seed = 0;
+
+	// 방아쇠를 당길 때마다 증가. 한 번의 넷 업데이트 안에서 시작/중지가 모두 일어나도 구분할 수 있도록
+	UPROPERTY()
+	uint8 Seq = 0;
+
+	// 중지 시점까지 발사된 탄 수
+	UPROPERTY()
+	uint8 ShotCount = 0;
+
+	UPROPERTY()
+	uint8 bFiring : 1;
+};
+
+template <>
+struct TStructOpsTypeTraits<FWeaponFireRecord> : TStructOpsTypeTraitsBase2<FWeaponFireRecord>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+USTRUCT(BlueprintType)
+struct FWeaponShot
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	float Time = 0.0f;
+
+	// 이번 프레임의 끝 시점으로부터 얼마나 이전에 발사되었는지
+	UPROPERTY(BlueprintReadOnly)
+	float TimeOffset = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly)
+	FVector Origin = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly)
+	FRotator Aim = FRotator::ZeroRotator;
+
+	// Aim에 이미 더해진 탄 퍼짐과 반동
+	UPROPERTY(BlueprintReadOnly)
+	FRotator Deviation = FRotator::ZeroRotator;
+};
+
 UCLASS()
 class CP0_API AWeapon : public AActor
 {
 	GENERATED_BODY()
 
+	friend class UBallisticsSubsystem;
+	friend class UWeaponPoolSubsystem;
+	friend class UWeaponComponent;
+
 public:
-	AWeapon();
+	AWeapon(const FObjectInitializer& Initializer);
 	UWeaponComponent* GetWeaponComp() const;
 	TSubclassOf<UAnimInstance> GetArmsAnimClass() const { return ArmsAnimClass; }
+	USkeletalMeshComponent* GetMesh() const { return Mesh; }
 
 	UFUNCTION(BlueprintCallable)
 	ACP0Character* GetCharOwner() const;
@@ -68,9 +158,14 @@ public:
 	void SwitchFireMode();
 
 	bool IsAiming() const { return bAiming; }
+	bool IsFiring() const { return Sim.bFiring; }
 	EWeaponState GetState() const { return State; }
 	EWeaponFireMode GetFireMode() const { return FireMode; }
 	float GetFireDelay() const { return 60.0f / Rpm; }
+	FWeaponSimParams GetSimParams() const;
+
+	UFUNCTION(BlueprintCallable)
+	const FWeaponShot& GetLastShot() const { return LastShot; }
 
 	UFUNCTION(BlueprintCallable)
 	void PlayMontage(UAnimMontage* ForWeapon, UAnimMontage* ForArms, UAnimMontage* ForBody) const;
@@ -86,6 +181,10 @@ protected:
 	virtual void BeginPlay() override;
 	virtual void Tick(float DeltaTime) override;
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void SetOwner(AActor* NewOwner) override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 
 	UFUNCTION(BlueprintImplementableEvent)
 	void OnFire();
@@ -93,6 +192,10 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent)
 	void OnDryFire();
 
+	// 서버 전용. 지연 보상을 거쳐 판정된 명중 결과
+	UFUNCTION(BlueprintImplementableEvent)
+	void OnFireHit(const FHitResult& Hit);
+
 	UFUNCTION(BlueprintImplementableEvent)
 	void OnReloadStart(bool bEmpty);
 
@@ -109,10 +212,14 @@ protected:
 	void OnHolster();
 
 private:
-	void Tick_Ready(float DeltaTime);
-	void Tick_Reloading(float DeltaTime);
-	void Tick_Deploying(float DeltaTime);
-	void Tick_Holstering(float DeltaTime);
+	void TakeFromPool();
+	void ReturnToPool();
+
+	void Tick_Firing(float DeltaTime);
+
+	void Complete_Reloading();
+	void Complete_Deploying();
+	void Complete_Holstering();
 
 	void Enter_Ready();
 	void Enter_Reloading();
@@ -124,36 +231,39 @@ private:
 	void Exit_Deploying();
 	void Exit_Holstering();
 
-	void BeginFiring(int32 RandSeed);
+	void BeginFiring(uint16 RandSeed);
 	void EndFiring();
 
-	bool Fire();
+	const FWeaponPattern& GetPattern() const;
+	FWeaponShot MakeShot(float TimeOffset, float DeltaTime) const;
+	void UpdateShotBase();
+
+	bool Fire(const FWeaponShot& Shot);
+	void ResolveShot(const FWeaponShot& Shot);
+	void Audit(EHitAuditEvent Event, float Time, const FHitResult* Hit = nullptr) const;
 	bool CanDoCommonAction() const;
 
 	void SetClip(uint8 NewClip);
 	void SetState(EWeaponState NewState);
 	void SetFireMode(EWeaponFireMode NewFm);
+	void SetStateTimer(float Time, void (AWeapon::*Callback)());
 
-	void CorrectClientState();
+	void UpdateClientCorrection();
+	void UpdateCorrection();
+	void ReconcileWithServer();
 	bool IsExpired(float LastModified) const;
 
-	UFUNCTION(Client, Unreliable)
-	void Client_CorrectState(FClientWeaponCorrectionData Data);
-
-	UFUNCTION(NetMulticast, Unreliable)
-	void Multicast_CorrectState(FMulticastWeaponCorrectionData Data);
-
-	UFUNCTION(Server, Reliable, WithValidation)
-	void Server_StartFiring(int32 RandSeed);
+	UFUNCTION()
+	void OnRep_ClientCorrection();
 
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_StartFiring(int32 RandSeed);
+	UFUNCTION()
+	void OnRep_Correction();
 
 	UFUNCTION(Server, Reliable, WithValidation)
-	void Server_StopFiring();
+	void Server_SetFiring(FWeaponFireRecord Record, float ViewTime);
 
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_StopFiring();
+	UFUNCTION()
+	void OnRep_FireRecord(const FWeaponFireRecord& Prev);
 
 	UFUNCTION()
 	void OnRep_State(EWeaponState OldState);
@@ -170,11 +280,49 @@ private:
 	UPROPERTY(Transient)
 	AWeapon* SwitchingTo;
 
-	FRandomStream FireRand;
+	FWeaponSim Sim;
+
+	// 클라이언트 전용. 처음 받은 FireRecord는 이 클라이언트가 보지 못한 과거이므로 재생하지 않는다
+	bool bFireRecordReceived = false;
 
 	UPROPERTY(EditAnywhere, meta = (UIMin = 1, ClampMin = 1))
 	float Rpm = 650.0f;
-	float FireLag;
+	float FireLagTime;
+
+	UPROPERTY(EditAnywhere, meta = (UIMin = 0, ClampMin = 0))
+	float Range = 50000.0f;
+
+	// 탄속 (cm/s). 0이면 히트스캔
+	UPROPERTY(EditAnywhere, meta = (UIMin = 0, ClampMin = 0))
+	float MuzzleVelocity = 0.0f;
+
+	// 이차 항력 계수 (1/cm)
+	UPROPERTY(EditAnywhere, meta = (UIMin = 0, ClampMin = 0))
+	float Drag = 1.3e-5f;
+
+	// 도 단위 탄 퍼짐 반경
+	UPROPERTY(EditAnywhere, meta = (UIMin = 0, ClampMin = 0))
+	float HipSpread = 1.0f;
+
+	UPROPERTY(EditAnywhere, meta = (UIMin = 0, ClampMin = 0))
+	float AimSpread = 0.2f;
+
+	// 한 발마다 누적되는 반동 (도)
+	UPROPERTY(EditAnywhere, meta = (UIMin = 0, ClampMin = 0))
+	float RecoilPitch = 0.15f;
+
+	UPROPERTY(EditAnywhere, meta = (UIMin = 0, ClampMin = 0))
+	float RecoilYaw = 0.1f;
+
+	// CDO에만 만들어지며 모든 인스턴스가 공유
+	mutable TUniquePtr<FWeaponPattern> Pattern;
+
+	FWeaponShot LastShot;
+	FVector PrevShotOrigin;
+	FRotator PrevShotAim;
+
+	// 서버 전용. 사격자가 보고 있던 화면이 서버 시각보다 얼마나 과거인지
+	float ShotTimeOffset;
 
 	UPROPERTY(EditAnywhere)
 	float ReloadTime_Tactical = 2.0f;
@@ -188,20 +336,19 @@ private:
 	UPROPERTY(EditAnywhere)
 	float HolsterTime = 0.67f;
 
-	float LastStateElapsedTime;
+	FTimerHandle StateTimer;
+	FTimerHandle ReconcileTimer;
 
 	float Clip_LastModified;
 	float FireMode_LastModified;
 	float State_LastModified;
 	float Aiming_LastModified;
-	float NextCorrection;
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	uint8 ClipSize = 30;
 
 	UPROPERTY(Transient, EditInstanceOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	uint8 Clip;
-	uint8 CurBurstCount;
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly,
 		meta = (AllowPrivateAccess = true, Bitmask, BitmaskEnum = EWeaponFireMode))
@@ -217,7 +364,16 @@ private:
 		= true))
 	EWeaponState State;
 
+	UPROPERTY(ReplicatedUsing = OnRep_FireRecord, Transient)
+	FWeaponFireRecord FireRecord;
+
+	// 서버의 값이 실제로 바뀌었을 때만 갱신되어 전송됨 (Push Model)
+	UPROPERTY(ReplicatedUsing = OnRep_ClientCorrection, Transient)
+	FClientWeaponCorrectionData ClientCorrection;
+
+	UPROPERTY(ReplicatedUsing = OnRep_Correction, Transient)
+	FMulticastWeaponCorrectionData Correction;
+
 	UPROPERTY(Replicated, Transient, EditInstanceOnly, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	uint8 bAiming : 1;
-	uint8 bFiring : 1;
 };
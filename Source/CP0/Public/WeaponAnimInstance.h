@@ -3,19 +3,38 @@
 #pragma once
 
 #include "Animation/AnimInstance.h"
+#include "AnimBudget.h"
 #include "CP0.h"
 #include "WeaponAnimInstance.generated.h"
 
-/**
- *
- */
+USTRUCT()
+struct FWeaponAnimInstanceProxy : public FBudgetedAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FWeaponAnimInstanceProxy() = default;
+
+	explicit FWeaponAnimInstanceProxy(UAnimInstance* Instance) : FBudgetedAnimInstanceProxy{Instance}
+	{
+	}
+
+protected:
+	void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	void Update(float DeltaSeconds) override;
+
+private:
+	EWeaponFireMode FireMode = {};
+};
+
 UCLASS()
 class CP0_API UWeaponAnimInstance : public UAnimInstance
 {
 	GENERATED_BODY()
 
 private:
-	void NativeUpdateAnimation(float DeltaSeconds) override;
+	friend FWeaponAnimInstanceProxy;
+
+	FAnimInstanceProxy* CreateAnimInstanceProxy() override;
 
 	UPROPERTY(EditInstanceOnly, Transient, BlueprintReadOnly, meta = (AllowPrivateAccess = true))
 	EWeaponFireMode FireMode;
@@ -23,10 +23,16 @@ public:
 
 	UFUNCTION(BlueprintCallable)
 	void EquipWeapon(AWeapon* NewWeapon);
+
+	// 서버 전용. 무기 풀에서 꺼내거나 새로 스폰해서 장착한다
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly)
+	AWeapon* EquipWeaponOfClass(TSubclassOf<AWeapon> Class);
 	
 	AWeapon* GetWeapon() const { return Weapon; }
 
 protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
@@ -39,6 +45,10 @@ private:
 	UPROPERTY(ReplicatedUsing = OnRep_Weapon, Transient, VisibleInstanceOnly, BlueprintReadOnly, meta = (
 		AllowPrivateAccess = true))
 	AWeapon* Weapon;
+
+	// 스폰될 때 서버가 풀에서 꺼내 장착하는 무기
+	UPROPERTY(EditDefaultsOnly)
+	TSubclassOf<AWeapon> DefaultWeaponClass;
 };
 
 struct CP0_API FInputAction_Fire
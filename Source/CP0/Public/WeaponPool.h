@@ -0,0 +1,48 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#pragma once
+
+#include "CP0.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WeaponPool.generated.h"
+
+class AWeapon;
+
+USTRUCT()
+struct FWeaponPoolBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AWeapon*> Weapons;
+};
+
+/**
+ * 서버 전용. 리스폰 때마다 무기를 스폰/파괴하지 않도록 클래스별로 쓰지 않는 무기를 숨겨서 보관한다.
+ * 보관 중인 무기는 소유자 없이 숨겨지고 네트워크 휴면 상태가 된다.
+ */
+UCLASS()
+class CP0_API UWeaponPoolSubsystem final : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr auto MaxPooledPerClass = 32;
+
+	// 보관 중인 무기가 있으면 초기 상태로 되돌려서 반환하고, 없으면 새로 스폰
+	UFUNCTION(BlueprintCallable, Category = "Weapon")
+	AWeapon* Acquire(TSubclassOf<AWeapon> Class, const FTransform& Transform);
+
+	UFUNCTION(BlueprintCallable, Category = "Weapon")
+	void Release(AWeapon* Weapon);
+
+	// 리스폰 웨이브 전에 미리 채워두기
+	UFUNCTION(BlueprintCallable, Category = "Weapon")
+	void Prewarm(TSubclassOf<AWeapon> Class, int32 Count);
+
+private:
+	AWeapon* Spawn(TSubclassOf<AWeapon> Class, const FTransform& Transform) const;
+
+	UPROPERTY(Transient)
+	TMap<UClass*, FWeaponPoolBucket> Buckets;
+};
@@ -0,0 +1,92 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#pragma once
+
+#include "CP0.h"
+
+enum class EWeaponFireResult : uint8
+{
+	// 탄이 없어서 발사되지 않음
+	Dry,
+	// 발사 후 사격 종료 (단발, 점사 완료)
+	Stop,
+	// 발사 후 계속 사격
+	Continue,
+	// 마지막 탄을 발사함
+	Empty
+};
+
+struct CP0_API FWeaponSimParams
+{
+	float FireDelay = 60.0f / 650.0f;
+	float ReloadTime_Tactical = 2.0f;
+	float ReloadTime_Empty = 3.0f;
+	uint8 ClipSize = 30;
+	uint8 BurstCount = 3;
+	uint8 FireModes = 0;
+
+	float GetReloadTime(uint8 Clip) const { return Clip > 0 ? ReloadTime_Tactical : ReloadTime_Empty; }
+	uint8 GetReloadedClip(uint8 Clip) const { return ClipSize + (Clip > 0); }
+	EWeaponFireMode GetNextFireMode(EWeaponFireMode FireMode) const;
+};
+
+/**
+ * 클래스마다 한 번만 만들어두는 탄 퍼짐/반동 패턴. 시드와 발 번호만으로 조회하므로 모든 머신에서 같은 값이 나온다.
+ */
+struct CP0_API FWeaponPattern
+{
+	static constexpr auto Size = 256;
+
+	void Build(uint32 Seed, float RecoilPitch, float RecoilYaw);
+
+	// (Pitch, Yaw) 도 단위. 단위 원 안의 퍼짐 방향에 SpreadAngle을 곱하고 누적 반동을 더한 값
+	FVector2D GetDeviation(int32 Seed, uint8 Shot, float SpreadAngle) const
+	{
+		return Spread[HashCombine(Seed, Shot) % Size] * SpreadAngle + Recoil[Shot];
+	}
+
+	FVector2D Spread[Size];
+	FVector2D Recoil[Size];
+};
+
+/**
+ * 월드나 액터 없이 명시적인 시간과 시드만으로 진행되는 사격 규칙.
+ * 탄창과 사격 모드는 복제되는 값이므로 소유자(AWeapon 등)가 들고 있고, 여기에는 사격 중의 상태만 둔다.
+ */
+struct CP0_API FWeaponSim
+{
+	// 첫 발을 바로 쏠 수 있으면 true. 이 때 호출자가 Fire()를 불러야 함
+	bool BeginFiring(const FWeaponSimParams& Params, int32 InSeed);
+	void EndFiring();
+
+	// 사격 중이 아닐 때 흐른 시간
+	void Idle(const FWeaponSimParams& Params, float DeltaTime);
+
+	EWeaponFireResult Fire(const FWeaponSimParams& Params, EWeaponFireMode FireMode, uint8& Clip);
+
+	/**
+	 * DeltaTime만큼 사격을 진행한다. 발사할 때마다 해당 발이 프레임 끝보다 몇 초 이전인지를 인자로
+	 * OnShot을 호출하며, OnShot이 false를 반환하면 사격을 종료한다.
+	 */
+	template <class FOnShot>
+	void Advance(const FWeaponSimParams& Params, float DeltaTime, FOnShot&& OnShot)
+	{
+		FireLag += DeltaTime;
+		while (bFiring && FireLag >= Params.FireDelay)
+		{
+			FireLag -= Params.FireDelay;
+			if (!OnShot(FireLag))
+			{
+				EndFiring();
+				break;
+			}
+		}
+	}
+
+	// 탄 퍼짐 패턴을 고르는 데 쓰인다
+	int32 Seed = 0;
+	float FireLag = 0.0f;
+	uint8 CurBurstCount = 0;
+	uint8 ShotCount = 0;
+	bool bFiring = false;
+};
@@ -0,0 +1,22 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+#pragma once
+
+#include "CP0.h"
+#include "Commandlets/Commandlet.h"
+#include "WeaponSimCommandlet.generated.h"
+
+/**
+ * 월드 없이 FWeaponSim을 대량으로 돌려 처리량과 결정성을 측정한다.
+ * 예: UE4Editor-Cmd CP0.uproject -run=WeaponSim -Weapons=100000 -Frames=600 -Hz=30 -Seed=1
+ * 같은 인자로 두 번 돌려서 상태 해시가 일치하는지 확인하며, 불일치하면 1을 반환한다.
+ */
+UCLASS()
+class CP0_API UWeaponSimCommandlet final : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UWeaponSimCommandlet();
+	int32 Main(const FString& Params) override;
+};
@@ -8,6 +8,8 @@ public class CP0EditorTarget : TargetRules
 	{
 		Type = TargetType.Editor;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
+		BuildEnvironment = TargetBuildEnvironment.Unique;
+		bWithPushModel = true;
 
 		ExtraModuleNames.AddRange(new[] {"CP0"});
 	}
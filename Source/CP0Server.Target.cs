@@ -0,0 +1,16 @@
+// (C) 2020 Seokjin Lee <seokjin.dev@gmail.com>
+
+using UnrealBuildTool;
+
+public class CP0ServerTarget : TargetRules
+{
+	public CP0ServerTarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Server;
+		DefaultBuildSettings = BuildSettingsVersion.V2;
+		BuildEnvironment = TargetBuildEnvironment.Unique;
+		bWithPushModel = true;
+
+		ExtraModuleNames.AddRange(new[] {"CP0"});
+	}
+}